@@ -165,6 +165,33 @@ cmd_profile() {
 	fi
 }
 
+cmd_startup() {
+	display_styled_symbol 33 "⬤" "Startup: $BUILD (target: $NAME)"
+	printf '\n'
+	RUNS=$OPTIONS
+	if [[ $RUNS == '' ]]; then
+		RUNS=10
+	fi
+	if $MAKE_EXEC BUILD=$BUILD; then
+		build_success_launch
+		for ((i = 0; i < RUNS; i++)); do
+			bin/$BUILD/$NAME --startup
+		done | awk '
+			$1 == "startup" { if (!($2 in count)) order[stages++] = $2; times[$2, count[$2]++] = $3 }
+			END {
+				printf "%-16s %10s %10s %10s\n", "stage (ms)", "min", "median", "max"
+				for (s = 0; s < stages; s++) {
+					name = order[s]; n = count[name]
+					for (i = 0; i < n; i++) sorted[i] = times[name, i]
+					for (i = 1; i < n; i++) for (j = i; j > 0 && sorted[j - 1] > sorted[j]; j--) { t = sorted[j]; sorted[j] = sorted[j - 1]; sorted[j - 1] = t }
+					printf "%-16s %10.2f %10.2f %10.2f\n", name, sorted[0], sorted[int((n - 1) / 2)], sorted[n - 1]
+				}
+			}'
+	else
+		build_fail
+	fi
+}
+
 #==============================================================================
 # Environment
 
@@ -268,11 +295,21 @@ for target in $BUILD_TARGETS; do
 		fi
 	fi
 
-	if [[ $NO_SRC_TARGET != 1 ]]; then
+	# Targets with their own Main.cpp are programs rather than libraries
+	if [[ $target != 'main' && -f src/$target/Main.cpp ]]; then
+		export NAME=$target
+		if [[ $PLATFORM == 'windows' ]]; then
+			NAME=$target.exe
+		fi
+	fi
+
+	if [[ $NO_SRC_TARGET != 1 && $target != 'main' ]]; then
 		export SRC_TARGET=$target
+	else
+		export SRC_TARGET=
 	fi
 
-	if [[ ($CMD == 'run' || $CMD == 'profile') && $target != 'main' ]]; then
+	if [[ ($CMD == 'run' || $CMD == 'profile' || $CMD == 'startup') && $target != 'main' ]]; then
 		continue
 	fi
 
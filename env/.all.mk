@@ -16,6 +16,11 @@ LINK_LIBRARIES := \
 
 PRECOMPILED_HEADER := PCH
 
+# Built separately with BUILD_TARGETS, see env/<target>/
+TARGET_DIRS := \
+	botserver \
+	tetriscore
+
 PRODUCTION_FOLDER := build
 
 PRODUCTION_EXCLUDE := \
@@ -25,6 +30,6 @@ PRODUCTION_EXCLUDE := \
 	Thumbs.db \
 	.DS_Store
 
-PRODUCTION_DEPENDENCIES := \
-	content
-
+# content/ ships packed into content.pak rather than as loose files
+PRODUCTION_ASSET_FOLDER := content
+PRODUCTION_ASSET_ARCHIVE := content.pak
@@ -0,0 +1,17 @@
+# The bot server runs the game engine headless, without SFML
+SHARED_SOURCE_FILES := \
+	Expectimax.cpp \
+	GameEvents.cpp \
+	GameSession.cpp \
+	Heuristic.cpp \
+	Mcts.cpp \
+	MoveGenerator.cpp \
+	SearchState.cpp \
+	Tetromino.cpp
+
+LINK_LIBRARIES := \
+	pthread
+
+BUILD_DEPENDENCIES :=
+
+BUILD_FLAGS := $(BUILD_FLAGS:-mwindows=)
@@ -14,6 +14,7 @@ BUILD_FLAGS := \
 LINK_LIBRARIES := \
 	$(LINK_LIBRARIES) \
 	stdc++fs \
+	rt \
 	X11
 
 PRODUCTION_LINUX_ICON := sfml
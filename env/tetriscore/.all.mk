@@ -0,0 +1,18 @@
+# libtetriscore is the engine behind a C interface, sources live in src/ and the folder only holds its PCH
+SHARED_SOURCE_FILES := \
+	GameEvents.cpp \
+	GameSession.cpp \
+	Heuristic.cpp \
+	MoveGenerator.cpp \
+	ShmRing.cpp \
+	TetrisCore.cpp \
+	Tetromino.cpp \
+	VecEnv.cpp
+
+CFLAGS := $(CFLAGS) -fvisibility=hidden -fvisibility-inlines-hidden
+
+LINK_LIBRARIES :=
+
+BUILD_DEPENDENCIES :=
+
+BUILD_FLAGS := $(BUILD_FLAGS:-mwindows=)
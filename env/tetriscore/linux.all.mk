@@ -0,0 +1,3 @@
+# shm_open lives in librt before glibc 2.34
+LINK_LIBRARIES := \
+	rt
@@ -0,0 +1,291 @@
+#include "Headers/AssetArchive.hpp"
+
+#ifndef _WIN32
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+constexpr char ASSET_ARCHIVE_MAGIC[4] = { 'T', 'P', 'A', 'K' };
+constexpr unsigned char ASSET_ARCHIVE_VERSION = 1;
+// Asset data starts on this boundary so decoders can read it in place
+constexpr unsigned char ASSET_ALIGNMENT = 16;
+// An index entry with an empty name, the name length then the offset and size
+constexpr unsigned char ASSET_MIN_ENTRY_SIZE = 2 + 16;
+
+namespace
+{
+// Archives are stored little endian regardless of the host
+void writeInteger(std::ostream& out, unsigned long long value, unsigned char size)
+{
+	for (unsigned char i = 0; i < size; i++)
+	{
+		out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+unsigned long long readInteger(const unsigned char* data, unsigned char size)
+{
+	unsigned long long value = 0;
+
+	for (unsigned char i = 0; i < size; i++)
+	{
+		value |= static_cast<unsigned long long>(data[i]) << (8 * i);
+	}
+
+	return value;
+}
+
+std::size_t align(std::size_t offset)
+{
+	return (offset + ASSET_ALIGNMENT - 1) / ASSET_ALIGNMENT * ASSET_ALIGNMENT;
+}
+}
+
+AssetArchive::~AssetArchive()
+{
+	close();
+}
+
+/// @brief Packs every file under the directory, named by its path relative to it with / separators. The layout is
+/// magic, version(1), asset count(4), then per asset name length(2), name, offset(8) and size(8), then the data of
+/// each asset aligned to 16 bytes, with the index sorted by name
+bool AssetArchive::pack(const std::string& directory, const std::string& path)
+{
+	struct Asset
+	{
+		std::string name;
+		std::vector<char> data;
+	};
+
+	std::vector<Asset> assets;
+	std::error_code error;
+
+	for (util::fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+	{
+		if (!util::fs::is_regular_file(it->path()))
+		{
+			continue;
+		}
+
+		std::ifstream file(it->path(), std::ios::binary);
+		Asset asset { util::fs::relative(it->path(), directory).generic_string(), {} };
+		asset.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		if (!file.good() && !file.eof())
+		{
+			std::cerr << "Could not read " << it->path() << std::endl;
+			return false;
+		}
+
+		assets.push_back(std::move(asset));
+	}
+
+	if (error)
+	{
+		std::cerr << "Could not list " << directory << ": " << error.message() << std::endl;
+		return false;
+	}
+
+	std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b) { return a.name < b.name; });
+
+	std::size_t offset = sizeof(ASSET_ARCHIVE_MAGIC) + 1 + 4;
+
+	for (const Asset& asset : assets)
+	{
+		offset += 2 + asset.name.size() + 8 + 8;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	file.write(ASSET_ARCHIVE_MAGIC, sizeof(ASSET_ARCHIVE_MAGIC));
+	writeInteger(file, ASSET_ARCHIVE_VERSION, 1);
+	writeInteger(file, assets.size(), 4);
+
+	std::vector<std::size_t> offsets;
+
+	for (const Asset& asset : assets)
+	{
+		offset = align(offset);
+		offsets.push_back(offset);
+
+		writeInteger(file, asset.name.size(), 2);
+		file.write(asset.name.data(), asset.name.size());
+		writeInteger(file, offset, 8);
+		writeInteger(file, asset.data.size(), 8);
+
+		offset += asset.data.size();
+	}
+
+	for (std::size_t i = 0; i < assets.size(); i++)
+	{
+		while (static_cast<std::size_t>(file.tellp()) < offsets[i])
+		{
+			file.put(0);
+		}
+
+		file.write(assets[i].data.data(), assets[i].data.size());
+	}
+
+	return static_cast<bool>(file);
+}
+
+/// @brief Maps the archive and reads its index, nothing else is touched until an asset is used
+bool AssetArchive::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	m_Buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	m_Data = m_Buffer.data();
+	m_Size = m_Buffer.size();
+#else
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+
+	if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+
+	void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	::close(descriptor);
+
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = status.st_size;
+#endif
+
+	if (!readIndex())
+	{
+		std::cerr << "Corrupt asset archive " << path << std::endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetArchive::close()
+{
+#ifdef _WIN32
+	m_Buffer.clear();
+	m_Buffer.shrink_to_fit();
+#else
+	if (m_Data != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(m_Data), m_Size);
+	}
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_Entries.clear();
+}
+
+/// @brief Looks an asset up by its path under content/, e.g. "arial.ttf"
+bool AssetArchive::find(const std::string& name, AssetSpan& span) const
+{
+	auto it = std::lower_bound(m_Entries.begin(), m_Entries.end(), name, [](const Entry& entry, const std::string& key)
+	{
+		return key.compare(0, std::string::npos, entry.name, entry.nameLength) > 0;
+	});
+
+	if (it == m_Entries.end() || name.compare(0, std::string::npos, it->name, it->nameLength) != 0)
+	{
+		return false;
+	}
+
+	span = it->span;
+
+	return true;
+}
+
+std::size_t AssetArchive::getAssetCount() const
+{
+	return m_Entries.size();
+}
+
+bool AssetArchive::readIndex()
+{
+	std::size_t position = sizeof(ASSET_ARCHIVE_MAGIC) + 1 + 4;
+
+	if (m_Size < position || std::memcmp(m_Data, ASSET_ARCHIVE_MAGIC, sizeof(ASSET_ARCHIVE_MAGIC)) != 0 ||
+		m_Data[sizeof(ASSET_ARCHIVE_MAGIC)] != ASSET_ARCHIVE_VERSION)
+	{
+		return false;
+	}
+
+	unsigned int count = readInteger(m_Data + sizeof(ASSET_ARCHIVE_MAGIC) + 1, 4);
+
+	// The count comes from the file, so it can't claim more entries than the rest of the file holds
+	if (count > (m_Size - position) / ASSET_MIN_ENTRY_SIZE)
+	{
+		return false;
+	}
+
+	m_Entries.reserve(count);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (position + 2 > m_Size)
+		{
+			return false;
+		}
+
+		Entry entry;
+		entry.nameLength = readInteger(m_Data + position, 2);
+		entry.name = reinterpret_cast<const char*>(m_Data + position + 2);
+		position += 2 + entry.nameLength;
+
+		if (position + 16 > m_Size)
+		{
+			return false;
+		}
+
+		std::size_t offset = readInteger(m_Data + position, 8);
+		entry.span.size = readInteger(m_Data + position + 8, 8);
+		entry.span.data = m_Data + offset;
+		position += 16;
+
+		if (offset > m_Size || entry.span.size > m_Size - offset)
+		{
+			return false;
+		}
+
+		// find() binary searches the index, so the names have to be in order
+		if (!m_Entries.empty() &&
+			std::string(m_Entries.back().name, m_Entries.back().nameLength).compare(0, std::string::npos, entry.name, entry.nameLength) >= 0)
+		{
+			return false;
+		}
+
+		m_Entries.push_back(entry);
+	}
+
+	return true;
+}
@@ -0,0 +1,91 @@
+#include "Headers/AudioEngine.hpp"
+
+AudioEngine::AudioEngine(IAudioOutput& output, GameEventQueue& events) :
+	m_Output(output),
+	m_Events(events)
+{
+}
+
+AudioEngine::~AudioEngine()
+{
+	stop();
+}
+
+/// @brief Prepares every effect up front, then starts the audio thread
+bool AudioEngine::start()
+{
+	if (m_Running || !m_Output.load())
+	{
+		return false;
+	}
+
+	m_Running = true;
+	m_Thread = std::thread(&AudioEngine::run, this);
+
+	return true;
+}
+
+void AudioEngine::stop()
+{
+	m_Running = false;
+
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+unsigned int AudioEngine::getPlayedCount() const
+{
+	return m_Played.load(std::memory_order_relaxed);
+}
+
+/// @brief Longest time from an event being published to its sound being started, in microseconds
+unsigned int AudioEngine::getMaxLatency() const
+{
+	return m_MaxLatency.load(std::memory_order_relaxed);
+}
+
+SoundEffect AudioEngine::getSoundEffect(const GameEvent& event)
+{
+	switch (event.type)
+	{
+		case EVENT_MOVE: return SOUND_MOVE;
+		case EVENT_ROTATE: return SOUND_ROTATE;
+		case EVENT_LOCK: return SOUND_LOCK;
+		case EVENT_CLEAR: return SOUND_CLEAR;
+		case EVENT_LEVEL_UP: return SOUND_LEVEL_UP;
+		default: return SOUND_NONE;
+	}
+}
+
+void AudioEngine::run()
+{
+	GameEvent event;
+
+	while (m_Running)
+	{
+		if (!m_Events.pop(event))
+		{
+			m_Events.wait(AUDIO_WAKE_TIMEOUT);
+			continue;
+		}
+
+		SoundEffect effect = getSoundEffect(event);
+
+		if (effect == SOUND_NONE)
+		{
+			continue;
+		}
+
+		m_Output.play(effect);
+
+		unsigned int latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - event.time).count();
+		m_Played.fetch_add(1, std::memory_order_relaxed);
+
+		if (latency > m_MaxLatency.load(std::memory_order_relaxed))
+		{
+			m_MaxLatency.store(latency, std::memory_order_relaxed);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+#include "Headers/Expectimax.hpp"
+#include "Headers/Heuristic.hpp"
+
+Expectimax::Expectimax(unsigned char depth, float minProbability, unsigned char tableBits) :
+	m_Depth(std::max<unsigned char>(1, std::min(depth, EXPECTIMAX_MAX_DEPTH))),
+	m_MinProbability(minProbability),
+	m_Table(1ULL << tableBits, Entry { 0, 0, 0 }),
+	m_TableMask((1ULL << tableBits) - 1)
+{
+	for (std::vector<Candidate>& candidates : m_Candidates)
+	{
+		candidates.reserve(2 * 4 * SEARCH_WIDTH * SEARCH_HEIGHT);
+	}
+}
+
+/// @brief Picks the placement with the best expected value. The table is kept between calls since the positions
+/// after the move played come up again on the next one
+bool Expectimax::search(const SearchState& state, Tetromino& best, bool& useHold)
+{
+	m_Nodes = 0;
+	m_TableHits = 0;
+
+	const Candidate* chosen = nullptr;
+	getDecisionValue(state, m_Depth, 1, &chosen);
+
+	if (chosen == nullptr)
+	{
+		return false;
+	}
+
+	useHold = chosen->useHold;
+	state.getPiece(useHold, m_Piece);
+	m_Generators[0].generate(state.matrix, m_Piece);
+	best = m_Generators[0].getPlacement(m_Generators[0].find(chosen->minos));
+
+	return true;
+}
+
+unsigned int Expectimax::getNodeCount() const
+{
+	return m_Nodes;
+}
+
+unsigned int Expectimax::getTableHits() const
+{
+	return m_TableHits;
+}
+
+/// @brief Best value over the placements of the current and hold piece, the top few searched one ply deeper.
+/// The root passes chosen to get the placement back, which also skips the table
+float Expectimax::getDecisionValue(const SearchState& state, unsigned char depth, float probability, const Candidate** chosen)
+{
+	if (depth == 0)
+	{
+		return Heuristic::evaluate(state.matrix, 0);
+	}
+
+	unsigned long long key = state.hash();
+	Entry& entry = m_Table[key & m_TableMask];
+
+	if (chosen == nullptr && entry.key == key && entry.depth >= depth)
+	{
+		m_TableHits++;
+		return entry.value;
+	}
+
+	m_Nodes++;
+	getCandidates(state, depth);
+	std::vector<Candidate>& candidates = m_Candidates[depth];
+
+	// Topping out is worse than any board
+	float value = -1e30f;
+
+	for (const Candidate& candidate : candidates)
+	{
+		float candidateValue = candidate.score;
+
+		if (depth > 1 && &candidate - candidates.data() < EXPECTIMAX_BEAM)
+		{
+			SearchState next = state;
+			next.apply(candidate.minos, candidate.shape, candidate.useHold);
+			candidateValue = candidate.linesCleared * HEURISTIC_LINES_WEIGHT + getChanceValue(next, depth - 1, probability);
+		}
+
+		if (candidateValue > value)
+		{
+			value = candidateValue;
+
+			if (chosen != nullptr)
+			{
+				*chosen = &candidate;
+			}
+		}
+	}
+
+	entry = { key, value, depth };
+	return value;
+}
+
+/// @brief Averages over the shapes left in the bag when the queue has run out. Unlikely branches get the static value
+float Expectimax::getChanceValue(const SearchState& state, unsigned char depth, float probability)
+{
+	if (depth == 0 || state.queueLength > 0)
+	{
+		return getDecisionValue(state, depth, probability);
+	}
+
+	unsigned char mask = state.getDrawMask();
+	float outcomeProbability = probability / __builtin_popcount(mask);
+
+	if (outcomeProbability < m_MinProbability)
+	{
+		return Heuristic::evaluate(state.matrix, 0);
+	}
+
+	float value = 0;
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		if (mask & (1 << shape))
+		{
+			SearchState next = state;
+			next.draw(static_cast<Tetromino::Shape>(shape));
+			value += getDecisionValue(next, depth, outcomeProbability);
+		}
+	}
+
+	return value / __builtin_popcount(mask);
+}
+
+/// @brief Fills the ply's candidate list with every placement, best static score first
+void Expectimax::getCandidates(const SearchState& state, unsigned char depth)
+{
+	std::vector<Candidate>& candidates = m_Candidates[depth];
+	MoveGenerator& generator = m_Generators[depth];
+	candidates.clear();
+
+	for (unsigned char hold = 0; hold < 2; hold++)
+	{
+		// Holding the same shape gives the same placements, holding into an empty slot needs the next piece known
+		if (hold && (state.hold == state.queue[0] || (state.hold == NO_HOLD && state.queueLength < 2)))
+		{
+			continue;
+		}
+
+		if (!state.getPiece(hold, m_Piece))
+		{
+			continue;
+		}
+
+		unsigned short placementCount = generator.generate(state.matrix, m_Piece);
+
+		for (unsigned short i = 0; i < placementCount; i++)
+		{
+			const Tetromino& placement = generator.getPlacement(i);
+			Matrix matrix = state.matrix;
+			unsigned char linesCleared = Heuristic::lock(matrix, placement.getMinos(), 1);
+
+			candidates.push_back({ Heuristic::evaluate(matrix, linesCleared), hold != 0, linesCleared, placement.getMinos(), placement.getShape() });
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+}
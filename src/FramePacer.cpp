@@ -0,0 +1,75 @@
+#include "Headers/FramePacer.hpp"
+
+FramePacer::FramePacer(Clock::duration slack) :
+	m_Slack(slack)
+{
+}
+
+/// @brief Sleeps until the slack before the deadline, returning at once inside it so the caller spins the rest while it
+/// keeps polling input
+void FramePacer::sleep(Clock::time_point deadline) const
+{
+	std::this_thread::sleep_until(deadline - m_Slack);
+}
+
+/// @brief Records the start of the frame that was due at the deadline
+void FramePacer::tick(Clock::time_point deadline, Clock::time_point now)
+{
+	unsigned int jitter = now > deadline ? std::chrono::duration_cast<std::chrono::microseconds>(now - deadline).count() : 0;
+
+	m_Frames++;
+	m_JitterSum += jitter;
+	m_MaxJitter = std::max(m_MaxJitter, jitter);
+	m_Histogram[std::min<unsigned int>(jitter / PACER_BUCKET_WIDTH, PACER_BUCKETS - 1)]++;
+}
+
+unsigned long long FramePacer::getFrameCount() const
+{
+	return m_Frames;
+}
+
+unsigned int FramePacer::getMeanJitter() const
+{
+	return m_Frames > 0 ? m_JitterSum / m_Frames : 0;
+}
+
+unsigned int FramePacer::getMaxJitter() const
+{
+	return m_MaxJitter;
+}
+
+/// @brief Upper edge of the histogram bucket holding the percentile, in microseconds
+unsigned int FramePacer::getJitterPercentile(double percentile) const
+{
+	unsigned long long rank = std::max<unsigned long long>(std::ceil(percentile / 100 * m_Frames), 1);
+	unsigned long long seen = 0;
+
+	for (unsigned short bucket = 0; bucket < PACER_BUCKETS - 1; bucket++)
+	{
+		seen += m_Histogram[bucket];
+
+		if (seen >= rank)
+		{
+			return (bucket + 1) * PACER_BUCKET_WIDTH;
+		}
+	}
+
+	return m_MaxJitter;
+}
+
+/// @brief Process CPU milliseconds per frame since the pacer was made, every thread included
+double FramePacer::getCpuPerFrame() const
+{
+	return m_Frames > 0 ? 1000.0 * (std::clock() - m_StartCpu) / CLOCKS_PER_SEC / m_Frames : 0;
+}
+
+void FramePacer::report(std::ostream& out) const
+{
+	double seconds = std::chrono::duration<double>(Clock::now() - m_StartTime).count();
+	double cpuSeconds = static_cast<double>(std::clock() - m_StartCpu) / CLOCKS_PER_SEC;
+
+	out << std::fixed << std::setprecision(2) << "frames " << m_Frames << " over " << seconds << " s\n"
+		<< "jitter mean " << getMeanJitter() / 1000.0 << " p99 " << getJitterPercentile(99) / 1000.0 << " max " << m_MaxJitter / 1000.0
+		<< " ms\n"
+		<< "cpu " << getCpuPerFrame() << " ms per frame, " << (seconds > 0 ? 100 * cpuSeconds / seconds : 0) << "% of a core\n";
+}
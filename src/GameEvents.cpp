@@ -0,0 +1,79 @@
+#include "Headers/GameEvents.hpp"
+
+/// @brief Called from the producer thread only
+bool GameEventQueue::push(const GameEvent& event)
+{
+	unsigned int tail = m_Tail.load(std::memory_order_relaxed);
+
+	if (tail - m_Head.load(std::memory_order_acquire) == GAME_EVENT_QUEUE_SIZE)
+	{
+		m_Dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	m_Events[tail % GAME_EVENT_QUEUE_SIZE] = event;
+	m_Tail.store(tail + 1, std::memory_order_release);
+
+	// Without the lock a wake can slip in just before the consumer sleeps, its timeout bounds how late it notices
+	m_Wake.notify_one();
+
+	return true;
+}
+
+/// @brief Called from the consumer thread only, returns false when there is nothing to read
+bool GameEventQueue::pop(GameEvent& event)
+{
+	unsigned int head = m_Head.load(std::memory_order_relaxed);
+
+	if (head == m_Tail.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	event = m_Events[head % GAME_EVENT_QUEUE_SIZE];
+	m_Head.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+/// @brief Sleeps until there is something to pop or the timeout runs out, returns whether there is
+bool GameEventQueue::wait(std::chrono::steady_clock::duration timeout)
+{
+	std::unique_lock<std::mutex> lock(m_WaitMutex);
+
+	return m_Wake.wait_for(lock, timeout, [&]()
+	{
+		return m_Head.load(std::memory_order_relaxed) != m_Tail.load(std::memory_order_acquire);
+	});
+}
+
+/// @brief Events lost because the consumer fell a whole queue behind
+unsigned int GameEventQueue::getDropped() const
+{
+	return m_Dropped.load(std::memory_order_relaxed);
+}
+
+/// @brief Hands out the next free queue, null once every one is taken
+GameEventQueue* GameEventBus::subscribe()
+{
+	unsigned char index = m_Subscribers.load(std::memory_order_relaxed);
+
+	if (index == GAME_EVENT_SUBSCRIBERS)
+	{
+		return nullptr;
+	}
+
+	m_Subscribers.store(index + 1, std::memory_order_release);
+
+	return &m_Queues[index];
+}
+
+void GameEventBus::publish(const GameEvent& event)
+{
+	unsigned char subscribers = m_Subscribers.load(std::memory_order_acquire);
+
+	for (unsigned char i = 0; i < subscribers; i++)
+	{
+		m_Queues[i].push(event);
+	}
+}
@@ -0,0 +1,508 @@
+#include "Headers/GameSession.hpp"
+#include "Headers/GameEvents.hpp"
+#include "Headers/Hash.hpp"
+
+template <typename Rules>
+BasicGameSession<Rules>::BasicGameSession()
+{
+	clearMatrix();
+}
+
+/// @brief Creates a session whose piece sequence is fully determined by the seed
+template <typename Rules>
+BasicGameSession<Rules>::BasicGameSession(unsigned long long seed) :
+	tetromino(seed)
+{
+	clearMatrix();
+}
+
+/// @brief Starts a new game after a game over. Score, level, timers and the board start over, the piece sequence and
+/// the handling carry on
+template <typename Rules>
+void BasicGameSession<Rules>::restart()
+{
+	score = 0;
+	totalLinesCleared = 0;
+	level = 1;
+	clearedLines = 0;
+	clearLineTimer = 0;
+	shiftDirection = 0;
+	shiftTimer = 0;
+	fallProgress = 0;
+	lockTimer = 0;
+	hardDropProcessed = true;
+	clearType = CLEAR_NORMAL;
+	combo = 0;
+	backToBack = false;
+
+	clearMatrix();
+
+	// The piece that topped out goes, the next one spawns on the empty board
+	currentGameState = GameState::IN_PROGRESS;
+	spawn();
+}
+
+/// @brief Advances the game by one logic frame. Only depends on the session and the input, so it can be replayed
+template <typename Rules>
+void BasicGameSession<Rules>::step(unsigned char input)
+{
+	unsigned char pressed = input & ~previousInput;
+	previousInput = input;
+
+	if (currentGameState == GameState::GAME_OVER)
+	{
+		if (input & INPUT_START)
+		{
+			restart();
+		}
+	}
+	else if (currentGameState == GameState::IN_PROGRESS)
+	{
+		// The locked piece waits out the clear animation, nothing can move, hold or drop it until the next one spawns
+		if (clearLineTimer > 0)
+		{
+			if (--clearLineTimer == 0)
+			{
+				removeClearedLines();
+			}
+		}
+		else
+		{
+			unsigned char rotation = tetromino.getRotation();
+
+			if (pressed & INPUT_ROTATE_CCW)
+			{
+				tetromino.rotate(false, matrix);
+			}
+			else if (pressed & INPUT_ROTATE_CW)
+			{
+				tetromino.rotate(true, matrix);
+			}
+
+			if (tetromino.getRotation() != rotation)
+			{
+				emit(EVENT_ROTATE, tetromino.getLastKick());
+			}
+
+			if (pressed & INPUT_HOLD)
+			{
+				hold();
+			}
+
+			// Shift first so a hard drop in the same frame lands where the piece was moved to
+			autoShift(input, pressed);
+
+			if (pressed & INPUT_HARD_DROP)
+			{
+				hardDropProcessed = false;
+				score += tetromino.hardDrop(matrix) * 2;
+			}
+
+			// A hard dropped piece is already on the ghost
+			if (!hardDropProcessed)
+			{
+				hardDropProcessed = true;
+				lockTetromino();
+			}
+			else
+			{
+				// Whole rows come out of the fixed point progress and fall in one step, however high the gravity
+				unsigned int gravity = Rules::Gravity::getGravity(level);
+				gravity = (input & INPUT_DOWN) ? std::min<unsigned int>(gravity * handling.softDropFactor, ROWS * GRAVITY_ONE) : gravity;
+				fallProgress += gravity;
+
+				unsigned int rows = std::min<unsigned int>(fallProgress / GRAVITY_ONE, ROWS);
+				unsigned char fallen = tetromino.fall(rows, matrix);
+				fallProgress %= GRAVITY_ONE;
+
+				if (input & INPUT_DOWN)
+				{
+					score += fallen;
+				}
+
+				if (fallen > 0)
+				{
+					lockTimer = 0;
+				}
+				else if (lockTimer < 255)
+				{
+					lockTimer++;
+				}
+
+				// A gravity step that can't move the piece locks it once it has rested for the lock delay
+				if (rows > 0 && fallen == 0 && lockTimer >= Rules::Lock::DELAY)
+				{
+					lockTetromino();
+				}
+			}
+		}
+	}
+	else if (currentGameState == GameState::NOT_STARTED)
+	{
+		if (input & INPUT_START)
+		{
+			currentGameState = GameState::IN_PROGRESS;
+			emit(EVENT_SPAWN);
+		}
+	}
+}
+
+/// @brief Delayed auto shift. A new press shifts once at once, holding it shifts again after das and then every arr,
+/// all in 1/256 frames so several repeats can land in one frame. An arr of 0 goes straight to the wall. Input is one
+/// byte a frame with no press time in it, so das counts from the start of the frame the key went down in
+template <typename Rules>
+void BasicGameSession<Rules>::autoShift(unsigned char input, unsigned char pressed)
+{
+	signed char direction = shiftDirection;
+
+	// The latest press wins, and releasing it hands over to the other direction if that's still held
+	if (pressed & INPUT_LEFT)
+	{
+		direction = -1;
+	}
+	else if (pressed & INPUT_RIGHT)
+	{
+		direction = 1;
+	}
+	else if (direction == -1 && !(input & INPUT_LEFT))
+	{
+		direction = (input & INPUT_RIGHT) ? 1 : 0;
+	}
+	else if (direction == 1 && !(input & INPUT_RIGHT))
+	{
+		direction = (input & INPUT_LEFT) ? -1 : 0;
+	}
+
+	if (direction == 0)
+	{
+		shiftDirection = 0;
+		shiftTimer = 0;
+		return;
+	}
+
+	unsigned char columns = 1;
+
+	if (direction != shiftDirection)
+	{
+		shiftDirection = direction;
+		shiftTimer = handling.das;
+	}
+	else
+	{
+		shiftTimer -= HANDLING_ONE;
+
+		if (shiftTimer > 0)
+		{
+			return;
+		}
+
+		if (handling.arr > 0)
+		{
+			unsigned int repeats = 1 + static_cast<unsigned int>(-shiftTimer) / handling.arr;
+			shiftTimer += repeats * handling.arr;
+			columns = std::min<unsigned int>(repeats, COLUMNS);
+		}
+		else
+		{
+			shiftTimer = 0;
+			columns = COLUMNS;
+		}
+	}
+
+	columns = tetromino.shift(direction, columns, matrix);
+
+	if (columns > 0)
+	{
+		emit(EVENT_MOVE, direction * columns);
+	}
+}
+
+/// @brief Swaps the active piece with the hold piece, once per piece
+template <typename Rules>
+bool BasicGameSession<Rules>::hold()
+{
+	if (hasHeld)
+	{
+		return false;
+	}
+
+	hasHeld = true;
+	tetromino.processHoldSwap(matrix);
+	emit(EVENT_HOLD);
+
+	return true;
+}
+
+/// @brief Locks the active piece where a MoveGenerator placement put it and clears lines without the animation delay,
+/// for bots that act on whole placements rather than frame inputs. Returns false once the game is over
+template <typename Rules>
+bool BasicGameSession<Rules>::place(const BasicTetromino<Rules>& placement)
+{
+	tetromino = placement;
+	lockTetromino();
+
+	if (clearLineTimer > 0)
+	{
+		clearLineTimer = 0;
+		removeClearedLines();
+	}
+
+	return currentGameState != GameState::GAME_OVER;
+}
+
+template <typename Rules>
+void BasicGameSession<Rules>::save(BasicGameSession& snapshot) const
+{
+	std::memcpy(static_cast<void*>(&snapshot), static_cast<const void*>(this), sizeof(BasicGameSession));
+}
+
+template <typename Rules>
+void BasicGameSession<Rules>::restore(const BasicGameSession& snapshot)
+{
+	std::memcpy(static_cast<void*>(this), static_cast<const void*>(&snapshot), sizeof(BasicGameSession));
+}
+
+/// @brief 64-bit hash of the complete game state, used to detect desyncs between replays and peers
+template <typename Rules>
+unsigned long long BasicGameSession<Rules>::hash() const
+{
+	unsigned long long hash = hashBytes(0, &matrix, sizeof(matrix));
+	hash = tetromino.hash(hash);
+	hash = hashWord(hash, (static_cast<unsigned long long>(static_cast<unsigned int>(score)) << 32) | static_cast<unsigned int>(totalLinesCleared));
+	hash = hashWord(hash, (static_cast<unsigned long long>(clearedLines) << 32) | fallProgress);
+
+	if (ROWS > 32)
+	{
+		hash = hashWord(hash, static_cast<unsigned long long>(clearedLines) >> 32);
+	}
+
+	hash = hashWord(hash, clearType | (static_cast<unsigned long long>(combo) << 8) | (static_cast<unsigned long long>(backToBack) << 16) |
+		(static_cast<unsigned long long>(lockTimer) << 24));
+
+	unsigned long long counters = currentGameState;
+	counters |= static_cast<unsigned long long>(clearLineTimer) << 8;
+	counters |= static_cast<unsigned long long>(level) << 32;
+	counters |= static_cast<unsigned long long>(static_cast<unsigned char>(shiftDirection)) << 40;
+	counters |= static_cast<unsigned long long>(hasHeld) << 48;
+	counters |= static_cast<unsigned long long>(hardDropProcessed) << 49;
+	counters |= static_cast<unsigned long long>(previousInput) << 56;
+	hash = hashWord(hash, counters);
+	hash = hashWord(hash, (static_cast<unsigned long long>(static_cast<unsigned int>(shiftTimer)) << 32) | handling.das);
+	hash = hashWord(hash, (static_cast<unsigned long long>(handling.arr) << 8) | handling.softDropFactor);
+
+	return finalizeHash(hash);
+}
+
+/// @brief Writes a human readable description of the state, for desync reports
+template <typename Rules>
+void BasicGameSession<Rules>::dump(std::ostream& out) const
+{
+	const char shapeNames[] = "ILJOSTZ";
+
+	out << "hash " << std::hex << hash() << std::dec
+		<< " state " << static_cast<int>(currentGameState)
+		<< " score " << score
+		<< " lines " << totalLinesCleared
+		<< " level " << static_cast<int>(level)
+		<< " combo " << static_cast<int>(combo)
+		<< " b2b " << backToBack << '\n'
+		<< "piece " << shapeNames[tetromino.getShape()]
+		<< " rotation " << static_cast<int>(tetromino.getRotation())
+		<< " next " << shapeNames[tetromino.getNextShape()]
+		<< " hold " << (tetromino.isHolding() ? shapeNames[tetromino.getHoldingShape()] : '-')
+		<< " fallProgress " << fallProgress
+		<< " shift " << static_cast<int>(shiftDirection) << ' ' << shiftTimer
+		<< " handling " << handling.das << ' ' << handling.arr << ' ' << static_cast<int>(handling.softDropFactor)
+		<< " clearLineTimer " << static_cast<int>(clearLineTimer)
+		<< " input " << static_cast<int>(previousInput) << '\n';
+
+	std::array<Vector2i, 4> minos = tetromino.getMinos();
+
+	for (unsigned char y = 0; y < ROWS; y++)
+	{
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			char cell = matrix[x][y] > 0 ? shapeNames[matrix[x][y] - 1] : '.';
+
+			for (const Vector2i& mino : minos)
+			{
+				if (mino.x == x && mino.y == y)
+				{
+					cell = '@';
+				}
+			}
+
+			out << cell;
+		}
+
+		out << '\n';
+	}
+}
+
+template <typename Rules>
+void BasicGameSession<Rules>::clearMatrix()
+{
+	for (std::array<unsigned char, ROWS>& column : matrix)
+	{
+		column.fill(0);
+	}
+}
+
+/// @brief Writes the landed tetromino into the matrix and either starts the line clear or spawns the next piece.
+/// Locking entirely in the hidden rows tops out
+template <typename Rules>
+void BasicGameSession<Rules>::lockTetromino()
+{
+	clearType = Rules::Scoring::getClearType(matrix, tetromino);
+	lockTimer = 0;
+	fallProgress = 0;
+	tetromino.updateMatrix(matrix);
+
+	if (Board::isLockedOut(tetromino.getMinos()))
+	{
+		emit(EVENT_LOCK, clearType);
+		currentGameState = GameState::GAME_OVER;
+		emit(EVENT_TOP_OUT);
+		return;
+	}
+
+	// Check if lines should be cleared
+	int lowY = ROWS;
+	int highY = 0;
+
+	for (Vector2i mino : tetromino.getMinos())
+	{
+		if (mino.y < lowY)
+		{
+			lowY = mino.y;
+		}
+
+		if (mino.y > highY)
+		{
+			highY = mino.y;
+		}
+	}
+
+	for (int i = std::max(lowY, 0); i <= highY; i++)
+	{
+		bool lineCleared = true;
+
+		for (int j = 0; j < COLUMNS; j++)
+		{
+			if (matrix[j][i] == 0)
+			{
+				lineCleared = false;
+				break;
+			}
+		}
+
+		if (lineCleared)
+		{
+			clearedLines |= static_cast<typename Board::RowMask>(1) << i;
+			clearLineTimer = 30;
+		}
+	}
+
+	emit(EVENT_LOCK, clearType);
+
+	// If there wasn't a line cleared, setup the next shape.
+	if (clearLineTimer == 0)
+	{
+		scoreClear(0);
+		spawn();
+	}
+	else
+	{
+		emit(EVENT_CLEAR, clearType, clearedLines);
+	}
+}
+
+/// @brief Collapses the rows marked in clearedLines once the clear animation finishes and scores them
+template <typename Rules>
+void BasicGameSession<Rules>::removeClearedLines()
+{
+	for (unsigned char clearedLine = 0; clearedLine < ROWS; clearedLine++)
+	{
+		if (((clearedLines >> clearedLine) & 1) == 0)
+		{
+			continue;
+		}
+
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			matrix[x][clearedLine] = 0;
+
+			for (unsigned char i = clearedLine; i > 0; i--)
+			{
+				matrix[x][i] = matrix[x][i - 1];
+				matrix[x][i - 1] = 0;
+			}
+		}
+	}
+
+	int clearedLineCount = __builtin_popcountll(clearedLines);
+	scoreClear(clearedLineCount);
+
+	totalLinesCleared += clearedLineCount;
+	unsigned char previousLevel = level;
+	level = std::max((totalLinesCleared / 10.0) + 1, 1.0);
+
+	if (level > previousLevel)
+	{
+		emit(EVENT_LEVEL_UP, level);
+	}
+	clearedLines = 0;
+	spawn();
+}
+
+/// @brief Scores the piece that just locked with the table lookup and carries the combo and back to back state on
+template <typename Rules>
+void BasicGameSession<Rules>::scoreClear(unsigned char linesCleared)
+{
+	score += Rules::Scoring::getScore(clearType, linesCleared, backToBack, combo) * level;
+
+	if (linesCleared > 0)
+	{
+		backToBack = isDifficultClear(clearType, linesCleared);
+		combo = std::min<unsigned char>(combo + 1, SCORE_COMBO_LIMIT - 1);
+	}
+	else
+	{
+		combo = 0;
+	}
+
+	clearType = CLEAR_NORMAL;
+}
+
+/// @brief Brings in the next piece, topping out if it doesn't fit where it spawns
+template <typename Rules>
+void BasicGameSession<Rules>::spawn()
+{
+	hasHeld = false;
+
+	if (tetromino.reset(matrix))
+	{
+		emit(EVENT_SPAWN);
+	}
+	else
+	{
+		currentGameState = GameState::GAME_OVER;
+		emit(EVENT_TOP_OUT);
+	}
+}
+
+template <typename Rules>
+void BasicGameSession<Rules>::emit(GameEventType type, signed char value, unsigned long long rows)
+{
+	if (events != nullptr)
+	{
+		events->publish({ type, tetromino.getShape(), value, rows, std::chrono::steady_clock::now() });
+	}
+}
+
+template struct BasicGameSession<GuidelineRules>;
+template struct BasicGameSession<ClassicRules>;
+template struct BasicGameSession<TgmRules>;
+template struct BasicGameSession<FourWideRules>;
+template struct BasicGameSession<SixteenWideRules>;
+template struct BasicGameSession<TallRules>;
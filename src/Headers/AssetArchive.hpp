@@ -0,0 +1,50 @@
+#pragma once
+
+// Where production builds put the packed content/, next to the executable's working directory
+constexpr char ASSET_ARCHIVE_PATH[] = "content.pak";
+
+// A view into the mapped archive, valid while the archive stays open
+struct AssetSpan
+{
+	const void* data = nullptr;
+	std::size_t size = 0;
+};
+
+/// @brief Every file under content/ packed into one indexed archive, so a cold start is a single map instead of a read
+/// per file. Assets are handed out as spans straight into the mapping, see pack for the layout
+class AssetArchive
+{
+public:
+	AssetArchive() = default;
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+	~AssetArchive();
+
+	static bool pack(const std::string& directory, const std::string& path);
+
+	bool open(const std::string& path);
+	void close();
+	bool find(const std::string& name, AssetSpan& span) const;
+
+	std::size_t getAssetCount() const;
+
+protected:
+	struct Entry
+	{
+		// Points into the mapping, names aren't terminated
+		const char* name;
+		unsigned short nameLength;
+		AssetSpan span;
+	};
+
+	const unsigned char* m_Data = nullptr;
+	std::size_t m_Size = 0;
+	// Sorted by name as pack wrote them
+	std::vector<Entry> m_Entries;
+#ifdef _WIN32
+	// No mmap, the archive is read in one go instead
+	std::vector<unsigned char> m_Buffer;
+#endif
+
+	bool readIndex();
+};
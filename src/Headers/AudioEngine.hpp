@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Headers/GameEvents.hpp"
+
+enum SoundEffect : unsigned char
+{
+	SOUND_MOVE,
+	SOUND_ROTATE,
+	SOUND_LOCK,
+	SOUND_CLEAR,
+	SOUND_LEVEL_UP,
+	SOUND_NONE
+};
+
+constexpr unsigned char SOUND_EFFECTS = SOUND_NONE;
+// Longest the audio thread sleeps, bounding how late it can notice an event whose wake it missed
+constexpr std::chrono::milliseconds AUDIO_WAKE_TIMEOUT(4);
+
+/// @brief Where the audio thread sends its sounds. load runs once before the thread starts, play only on the thread
+struct IAudioOutput
+{
+	virtual ~IAudioOutput() = default;
+	virtual bool load() = 0;
+	virtual void play(SoundEffect effect) = 0;
+};
+
+/// @brief Plays a sound for every game event on its own thread. The game thread only pushes to its lock-free event
+/// queue, it never waits on the output, files or the mixer. Keeps the time from each event to its sound starting
+class AudioEngine
+{
+public:
+	AudioEngine(IAudioOutput& output, GameEventQueue& events);
+	AudioEngine(const AudioEngine&) = delete;
+	AudioEngine& operator=(const AudioEngine&) = delete;
+	~AudioEngine();
+
+	bool start();
+	void stop();
+
+	unsigned int getPlayedCount() const;
+	unsigned int getMaxLatency() const;
+
+	static SoundEffect getSoundEffect(const GameEvent& event);
+
+protected:
+	IAudioOutput& m_Output;
+	GameEventQueue& m_Events;
+	std::thread m_Thread;
+	std::atomic<bool> m_Running { false };
+
+	std::atomic<unsigned int> m_Played { 0 };
+	// Microseconds
+	std::atomic<unsigned int> m_MaxLatency { 0 };
+
+	void run();
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+/// @brief The narrowest unsigned integer with at least BITS bits
+template <unsigned char BITS>
+using UnsignedBits = std::conditional_t<BITS <= 8, unsigned char,
+	std::conditional_t<BITS <= 16, unsigned short, std::conditional_t<BITS <= 32, unsigned int, unsigned long long>>>;
+
+/// @brief Board policy of a rule set, see Rules.hpp. WIDTH by HEIGHT visible cells under BUFFER hidden rows, the
+/// matrix holds both with row 0 at the top of the buffer. New pieces center on column SPAWN_COLUMN and row SPAWN_ROW
+template <unsigned char WIDTH, unsigned char HEIGHT, unsigned char BUFFER = 0, unsigned char SPAWN_COLUMN = WIDTH / 2,
+	unsigned char SPAWN_ROW = BUFFER + 1>
+struct BasicBoard
+{
+	static_assert(WIDTH >= 4 && WIDTH <= 64, "Rows must fit an I piece and a 64-bit mask");
+	static_assert(HEIGHT + BUFFER >= 4 && HEIGHT + BUFFER <= 64, "The matrix must fit an I piece and a 64-bit row mask");
+	static_assert(SPAWN_COLUMN >= 2 && SPAWN_COLUMN + 1 < WIDTH && SPAWN_ROW >= 1 && SPAWN_ROW + 1 < HEIGHT + BUFFER,
+		"Every shape must spawn inside the matrix");
+
+	static constexpr unsigned char COLUMNS = WIDTH;
+	static constexpr unsigned char ROWS = HEIGHT + BUFFER;
+	static constexpr unsigned char VISIBLE_ROWS = HEIGHT;
+	static constexpr unsigned char BUFFER_ROWS = BUFFER;
+	static constexpr unsigned char SPAWN_X = SPAWN_COLUMN;
+	static constexpr unsigned char SPAWN_Y = SPAWN_ROW;
+
+	// Cells indexed as matrix[x][y], 0 is empty and 1 + Tetromino::Shape is a placed mino
+	using Matrix = std::array<std::array<unsigned char, ROWS>, COLUMNS>;
+	// Bit x set for column x of one row
+	using Row = UnsignedBits<COLUMNS>;
+	// Bit y set for row y of the matrix
+	using RowMask = UnsignedBits<ROWS>;
+
+	static constexpr Row FULL_ROW = static_cast<Row>(~0ULL >> (64 - COLUMNS));
+	static constexpr RowMask VISIBLE_MASK = static_cast<RowMask>(~0ULL >> (64 - ROWS) >> BUFFER << BUFFER);
+
+	/// @brief Whether a cell stops a piece. Walls and the floor do, the open space above the matrix doesn't. The bounds
+	/// are compile time constants and the lookup is clamped, so checking a piece compiles to compares without branches
+	static bool isBlocked(const Matrix& matrix, int x, int y)
+	{
+		bool isWall = (static_cast<unsigned int>(x) >= COLUMNS) | (y >= ROWS);
+		bool isFilled = matrix[std::min<unsigned int>(x, COLUMNS - 1)][std::clamp(y, 0, ROWS - 1)] != 0;
+
+		return isWall | ((y >= 0) & isFilled);
+	}
+
+	/// @brief Whether every mino moved by offset lands on an open cell
+	static bool fits(const Matrix& matrix, const std::array<Vector2i, 4>& minos, Vector2i offset)
+	{
+		bool isBlockedAny = false;
+
+		for (const Vector2i& mino : minos)
+		{
+			isBlockedAny |= isBlocked(matrix, mino.x + offset.x, mino.y + offset.y);
+		}
+
+		return !isBlockedAny;
+	}
+
+	/// @brief Lock out, a piece locking without a mino in the visible rows or with one above the matrix where it can't
+	/// be kept. One mask of the rows the piece covers decides both
+	static bool isLockedOut(const std::array<Vector2i, 4>& minos)
+	{
+		RowMask rows = 0;
+		bool isAbove = false;
+
+		for (const Vector2i& mino : minos)
+		{
+			isAbove |= mino.y < 0;
+			rows |= static_cast<RowMask>(1) << std::max(mino.y, 0);
+		}
+
+		return isAbove | ((rows & VISIBLE_MASK) == 0);
+	}
+};
+
+// The board the game, the bots and the tools play on
+using StandardBoard = BasicBoard<COLUMNS, VISIBLE_ROWS, BUFFER_ROWS>;
+
+static_assert(std::is_same<StandardBoard::Matrix, Matrix>::value, "Matrix is the standard board's");
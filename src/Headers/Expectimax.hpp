@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Headers/MoveGenerator.hpp"
+#include "Headers/SearchState.hpp"
+
+constexpr unsigned char EXPECTIMAX_MAX_DEPTH = 6;
+// Placements searched deeper per decision, the rest only get the static evaluation
+constexpr unsigned char EXPECTIMAX_BEAM = 8;
+
+/// @brief Depth limited expectimax over placements. Pieces past the known queue are chance nodes averaged over what
+/// is left of the 7-bag, so the search never considers a shape the bag can't give. Branches whose probability falls
+/// below a threshold are valued statically, and results are memoized per board, queue, hold and bag
+class Expectimax
+{
+public:
+	explicit Expectimax(unsigned char depth = 3, float minProbability = 0.1f, unsigned char tableBits = 18);
+
+	bool search(const SearchState& state, Tetromino& best, bool& useHold);
+
+	unsigned int getNodeCount() const;
+	unsigned int getTableHits() const;
+
+protected:
+	struct Entry
+	{
+		unsigned long long key;
+		float value;
+		unsigned char depth;
+	};
+
+	struct Candidate
+	{
+		float score;
+		bool useHold;
+		unsigned char linesCleared;
+		std::array<Vector2i, 4> minos;
+		Tetromino::Shape shape;
+	};
+
+	unsigned char m_Depth;
+	float m_MinProbability;
+	std::vector<Entry> m_Table;
+	unsigned long long m_TableMask;
+
+	// One generator and candidate list per ply since the search recurses while iterating them
+	std::array<MoveGenerator, EXPECTIMAX_MAX_DEPTH + 1> m_Generators;
+	std::array<std::vector<Candidate>, EXPECTIMAX_MAX_DEPTH + 1> m_Candidates;
+	Tetromino m_Piece { 1 };
+
+	unsigned int m_Nodes = 0;
+	unsigned int m_TableHits = 0;
+
+	float getDecisionValue(const SearchState& state, unsigned char depth, float probability, const Candidate** chosen = nullptr);
+	float getChanceValue(const SearchState& state, unsigned char depth, float probability);
+	void getCandidates(const SearchState& state, unsigned char depth);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+// Lateness histogram buckets, the last one holds everything later
+constexpr unsigned short PACER_BUCKET_WIDTH = 100;
+constexpr unsigned short PACER_BUCKETS = 200;
+
+/// @brief Sleeps the main loop until shortly before the next frame is due and leaves the last stretch to a spin, so the
+/// loop neither burns a core between frames nor oversleeps the deadline. Keeps how late each frame started and the
+/// process CPU time spent per frame
+class FramePacer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit FramePacer(Clock::duration slack = std::chrono::milliseconds(2));
+
+	void sleep(Clock::time_point deadline) const;
+	void tick(Clock::time_point deadline, Clock::time_point now);
+
+	unsigned long long getFrameCount() const;
+	unsigned int getMeanJitter() const;
+	unsigned int getMaxJitter() const;
+	unsigned int getJitterPercentile(double percentile) const;
+	double getCpuPerFrame() const;
+	void report(std::ostream& out) const;
+
+protected:
+	Clock::duration m_Slack;
+
+	unsigned long long m_Frames = 0;
+	// Microseconds each frame started after its deadline
+	unsigned long long m_JitterSum = 0;
+	unsigned int m_MaxJitter = 0;
+	std::array<unsigned int, PACER_BUCKETS> m_Histogram {};
+
+	std::clock_t m_StartCpu = std::clock();
+	Clock::time_point m_StartTime = Clock::now();
+};
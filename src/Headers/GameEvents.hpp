@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+enum GameEventType : unsigned char
+{
+	// value is unused
+	EVENT_SPAWN,
+	// value is the signed number of columns shifted
+	EVENT_MOVE,
+	// value is 1 + the kick offset used
+	EVENT_ROTATE,
+	// value is the ClearType the piece locked with
+	EVENT_LOCK,
+	// rows has a bit set for every row cleared, value is the ClearType
+	EVENT_CLEAR,
+	// value is unused, shape is the piece that came out of hold
+	EVENT_HOLD,
+	EVENT_TOP_OUT,
+	// value is the new level
+	EVENT_LEVEL_UP
+};
+
+struct GameEvent
+{
+	GameEventType type;
+	// The active piece's shape once the event happened
+	unsigned char shape;
+	signed char value;
+	unsigned long long rows;
+	// When the game thread published it, for consumers that measure their own latency
+	std::chrono::steady_clock::time_point time;
+};
+
+// Events a consumer can fall behind by before new ones are dropped
+constexpr unsigned short GAME_EVENT_QUEUE_SIZE = 256;
+constexpr unsigned char GAME_EVENT_SUBSCRIBERS = 4;
+
+/// @brief Single producer, single consumer ring of game events. Pushing never blocks or allocates, a full queue drops
+/// the event and counts it instead. A consumer can sleep in wait, the producer wakes it without taking the lock
+class GameEventQueue
+{
+public:
+	bool push(const GameEvent& event);
+	bool pop(GameEvent& event);
+	bool wait(std::chrono::steady_clock::duration timeout);
+
+	unsigned int getDropped() const;
+
+protected:
+	std::array<GameEvent, GAME_EVENT_QUEUE_SIZE> m_Events;
+	// Each side writes only its own index, on its own cache line
+	alignas(64) std::atomic<unsigned int> m_Head { 0 };
+	alignas(64) std::atomic<unsigned int> m_Tail { 0 };
+	std::atomic<unsigned int> m_Dropped { 0 };
+
+	std::mutex m_WaitMutex;
+	std::condition_variable m_Wake;
+};
+
+/// @brief Fans the events of the game thread out to one queue per consumer, such as audio, telemetry or netplay, which
+/// each drain theirs on their own thread. Consumers subscribe before the game starts publishing
+class GameEventBus
+{
+public:
+	GameEventQueue* subscribe();
+	void publish(const GameEvent& event);
+
+protected:
+	std::array<GameEventQueue, GAME_EVENT_SUBSCRIBERS> m_Queues;
+	std::atomic<unsigned char> m_Subscribers { 0 };
+};
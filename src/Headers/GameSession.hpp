@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+#include "Headers/Rules.hpp"
+#include "Headers/Tetromino.hpp"
+
+class GameEventBus;
+enum GameEventType : unsigned char;
+
+/// @brief Every piece of mutable game state. Kept trivially copyable so a whole game can be saved and restored with one memcpy.
+/// Rules picks rotation, randomizer, scoring, gravity, locking and the board at compile time, see Rules.hpp
+template <typename Rules>
+struct BasicGameSession
+{
+	using Board = typename Rules::Board;
+	using Matrix = typename Board::Matrix;
+	static constexpr unsigned char COLUMNS = Board::COLUMNS;
+	static constexpr unsigned char ROWS = Board::ROWS;
+
+	Matrix matrix;
+	BasicTetromino<Rules> tetromino;
+
+	int score = 0;
+	int totalLinesCleared = 0;
+
+	// Bitmask of the rows waiting to be cleared, bit y set for row y
+	typename Board::RowMask clearedLines = 0;
+	// Fraction of a row fallen so far, in GRAVITY_ONE fixed point
+	unsigned int fallProgress = 0;
+	// How the piece that cleared them locked
+	ClearType clearType = CLEAR_NORMAL;
+	// Line clears in a row so far, saturating at the end of the score table
+	unsigned char combo = 0;
+	bool backToBack = false;
+
+	GameState currentGameState = GameState::NOT_STARTED;
+	unsigned char clearLineTimer = 0;
+	unsigned char level = 1;
+	// Direction being auto shifted, -1 left, 1 right or 0
+	signed char shiftDirection = 0;
+	// Frames since the piece last fell, for the lock delay
+	unsigned char lockTimer = 0;
+	bool hasHeld = false;
+
+	// Time left until the next auto shift, in 1/256 frames
+	int shiftTimer = 0;
+	Handling handling;
+
+	// Input state
+	bool hardDropProcessed = true;
+	unsigned char previousInput = 0;
+
+	// Where to publish spawns, moves, locks and the like, null for bots and rollback resimulation
+	GameEventBus* events = nullptr;
+
+	BasicGameSession();
+	explicit BasicGameSession(unsigned long long seed);
+
+	void restart();
+	void step(unsigned char input);
+	bool hold();
+	bool place(const BasicTetromino<Rules>& placement);
+	void save(BasicGameSession& snapshot) const;
+	void restore(const BasicGameSession& snapshot);
+
+	unsigned long long hash() const;
+	void dump(std::ostream& out) const;
+
+protected:
+	void clearMatrix();
+	void lockTetromino();
+	void removeClearedLines();
+	void autoShift(unsigned char input, unsigned char pressed);
+	void scoreClear(unsigned char linesCleared);
+	void spawn();
+	void emit(GameEventType type, signed char value = 0, unsigned long long rows = 0);
+};
+
+using GameSession = BasicGameSession<GuidelineRules>;
+
+static_assert(std::is_trivially_copyable<GameSession>::value, "GameSession must stay trivially copyable");
+static_assert(std::is_standard_layout<GameSession>::value, "GameSession must stay standard layout");
@@ -1,17 +1,85 @@
+#pragma once
+
 constexpr unsigned char CELL_SIZE = 8;
 constexpr unsigned char COLUMNS = 10;
 constexpr unsigned char INFO_VIEW = 80;
-constexpr unsigned char ROWS = 20;
+constexpr unsigned char VISIBLE_ROWS = 20;
+// Hidden rows above the visible ones, enough for any spawn rotation and its kicks. Rows 0 to BUFFER_ROWS - 1
+constexpr unsigned char BUFFER_ROWS = 4;
+constexpr unsigned char ROWS = VISIBLE_ROWS + BUFFER_ROWS;
 constexpr unsigned char SCREEN_RESIZE = 4;
-constexpr unsigned char MOVE_SPEED = 4;
 constexpr unsigned char START_FALL_SPEED = 32;
 
 constexpr unsigned short FRAME_DURATION = 16667;
 
+// Standard playfield cells indexed as matrix[x][y] with the hidden rows on top, 0 is empty and 1 + Tetromino::Shape
+// is a placed mino. Rule sets can play on other sizes, see Board.hpp
+using Matrix = std::array<std::array<unsigned char, ROWS>, COLUMNS>;
+
+/// @brief Board coordinates of a mino. The engine has its own type so it builds without SFML
+struct Vector2i
+{
+	int x = 0;
+	int y = 0;
+
+	Vector2i() = default;
+	constexpr Vector2i(int x, int y) :
+		x(x),
+		y(y)
+	{
+	}
+};
+
+constexpr bool operator==(const Vector2i& a, const Vector2i& b)
+{
+	return a.x == b.x && a.y == b.y;
+}
+
+constexpr bool operator!=(const Vector2i& a, const Vector2i& b)
+{
+	return !(a == b);
+}
+
+constexpr Vector2i operator+(const Vector2i& a, const Vector2i& b)
+{
+	return Vector2i(a.x + b.x, a.y + b.y);
+}
+
+constexpr Vector2i operator-(const Vector2i& a, const Vector2i& b)
+{
+	return Vector2i(a.x - b.x, a.y - b.y);
+}
+
+// Auto shift timings are in 1/256 frames so handling set in milliseconds isn't rounded to whole frames
+constexpr unsigned short HANDLING_ONE = 256;
+
+// Longest DAS or ARR a handling time holds, about four seconds
+constexpr unsigned int MAX_HANDLING_MILLISECONDS = 0xFFFFu * FRAME_DURATION / (1000 * HANDLING_ONE);
+
+constexpr unsigned short getHandlingTime(unsigned int milliseconds)
+{
+	return milliseconds * 1000 * HANDLING_ONE / FRAME_DURATION;
+}
+
+static_assert(MAX_HANDLING_MILLISECONDS * 1000ULL * HANDLING_ONE / FRAME_DURATION <= 0xFFFF, "Handling times must not wrap");
+
+/// @brief Player handling settings, part of the session so replays and netplay simulate them the same way
+struct Handling
+{
+	// Delayed auto shift, how long a direction is held before it repeats
+	unsigned short das = 4 * HANDLING_ONE;
+	// Auto repeat rate, the time between repeated shifts. 0 shifts straight to the wall
+	unsigned short arr = 4 * HANDLING_ONE;
+	// Gravity multiplier while soft dropping
+	unsigned char softDropFactor = 20;
+};
+
+/// @brief Where a piece is, packed: the origin its footprint is laid out from and the rotation picking the footprint
 struct Position
 {
-	char x;
-	char y;
+	signed char x;
+	signed char y;
+	unsigned char rotation;
 };
 
 enum GameState : unsigned char
@@ -19,4 +87,17 @@ enum GameState : unsigned char
 	NOT_STARTED,
 	IN_PROGRESS,
 	GAME_OVER
+};
+
+// Buttons held during a logic frame, passed as a bitmask to GameSession::step
+enum Input : unsigned char
+{
+	INPUT_LEFT = 1 << 0,
+	INPUT_RIGHT = 1 << 1,
+	INPUT_DOWN = 1 << 2,
+	INPUT_ROTATE_CCW = 1 << 3,
+	INPUT_ROTATE_CW = 1 << 4,
+	INPUT_HOLD = 1 << 5,
+	INPUT_HARD_DROP = 1 << 6,
+	INPUT_START = 1 << 7
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+/// @brief Mixes one 64-bit word into a running state hash
+inline unsigned long long hashWord(unsigned long long hash, unsigned long long word)
+{
+	hash ^= word * 0x9E3779B97F4A7C15ULL;
+	hash = (hash << 27) | (hash >> 37);
+	return hash * 0xC2B2AE3D27D4EB4FULL;
+}
+
+/// @brief Mixes a block of bytes into a running state hash, eight bytes at a time
+inline unsigned long long hashBytes(unsigned long long hash, const void* data, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+	for (; size >= 8; bytes += 8, size -= 8)
+	{
+		unsigned long long word;
+		std::memcpy(&word, bytes, 8);
+		hash = hashWord(hash, word);
+	}
+
+	if (size > 0)
+	{
+		unsigned long long word = 0;
+		std::memcpy(&word, bytes, size);
+		hash = hashWord(hash, word);
+	}
+
+	return hash;
+}
+
+/// @brief Final avalanche so that single bit differences spread over the whole hash
+inline unsigned long long finalizeHash(unsigned long long hash)
+{
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EBULL;
+	return hash ^ (hash >> 31);
+}
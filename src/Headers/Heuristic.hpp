@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+// Worth of a cleared line relative to the board shape terms, for search that adds up clears along a path
+constexpr float HEURISTIC_LINES_WEIGHT = 0.76f;
+
+/// @brief Board shape evaluation shared by the search bots
+class Heuristic
+{
+public:
+	static unsigned char lock(Matrix& matrix, const std::array<Vector2i, 4>& minos, unsigned char cell);
+	static float evaluate(const Matrix& matrix, unsigned char linesCleared);
+	static int getLineClearScore(unsigned char linesCleared, int level);
+};
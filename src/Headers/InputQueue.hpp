@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+// Key events waiting for their frame, more than a frame's worth of mashing folds the oldest into the held state
+constexpr unsigned char INPUT_QUEUE_SIZE = 64;
+
+/// @brief Key presses and releases stamped as they arrive, handed out by the frame whose window they fall in rather than
+/// whenever the fixed step loop gets around to draining them
+class InputQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	void push(unsigned char bits, bool pressed, Clock::time_point time);
+	unsigned char popFrame(Clock::time_point frameEnd);
+	void clear();
+
+protected:
+	struct Event
+	{
+		Clock::time_point time;
+		unsigned char bits;
+		bool pressed;
+	};
+
+	std::array<Event, INPUT_QUEUE_SIZE> m_Events;
+	unsigned char m_Head = 0;
+	unsigned char m_Count = 0;
+	unsigned char m_Held = 0;
+	// Presses applied but not yet handed to a frame, so a tap shorter than a frame still registers
+	unsigned char m_Tapped = 0;
+
+	void apply(const Event& event);
+};
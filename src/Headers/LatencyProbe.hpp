@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+enum LatencyStage : unsigned char
+{
+	LATENCY_CONSUMED,
+	LATENCY_DRAWN,
+	LATENCY_PRESENTED
+};
+
+constexpr unsigned char LATENCY_STAGES = 3;
+// One kind per input bit
+constexpr unsigned char LATENCY_KINDS = 8;
+
+/// @brief Input to photon diagnostics. Every key press is followed from the moment it was polled to the logic frame
+/// that consumed it, the draw submission of that frame and the return of display, and the time to each stage is
+/// kept per input kind. The logic and render threads both report to it, so it takes a lock
+class LatencyProbe
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	void received(unsigned char bits, Clock::time_point time);
+	void consumed(Clock::time_point frameEnd, Clock::time_point time);
+	void drawn(Clock::time_point frameEnd, Clock::time_point time);
+	void presented(Clock::time_point time);
+
+	std::size_t getSampleCount(unsigned char kind) const;
+	unsigned int getPercentile(unsigned char kind, LatencyStage stage, double percentile) const;
+	void report(std::ostream& out) const;
+
+protected:
+	struct Sample
+	{
+		Clock::time_point received;
+		Clock::time_point consumed;
+		Clock::time_point drawn;
+		unsigned char kind;
+		// Number of stages reached so far
+		unsigned char stages;
+	};
+
+	mutable std::mutex m_Mutex;
+	std::vector<Sample> m_Pending;
+	// Microseconds from receipt to each stage, by input kind and stage
+	std::array<std::array<std::vector<unsigned int>, LATENCY_STAGES>, LATENCY_KINDS> m_Latencies;
+};
+
+/// @brief Injects key presses on a timer for the latency self-test, cycling through every input kind. Each key is held
+/// for half the period, and an odd period keeps the presses drifting across the frame
+class SyntheticInput
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	SyntheticInput(Clock::time_point start, Clock::duration period);
+
+	bool poll(Clock::time_point now, unsigned char& bits, bool& pressed);
+
+protected:
+	Clock::time_point m_Next;
+	Clock::duration m_Period;
+	unsigned char m_Kind = 0;
+	bool m_Pressed = false;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Headers/MoveGenerator.hpp"
+#include "Headers/SearchState.hpp"
+
+constexpr unsigned int MCTS_NONE = 0xFFFFFFFF;
+constexpr unsigned char MCTS_MAX_DEPTH = 32;
+constexpr unsigned char MCTS_ROLLOUT_PIECES = 2;
+
+/// @brief Monte Carlo tree search over placements. Decision nodes choose a placement from MoveGenerator, the bag draws
+/// that follow it are chance outcomes sampled the same way SevenBagRandomizer::draw draws. Iterations run on a
+/// thread pool with virtual loss, nodes come from fixed pools and the subtree of the move actually played is kept
+class Mcts
+{
+public:
+	explicit Mcts(unsigned char threadCount = 0, unsigned int nodeCapacity = 1 << 15);
+	~Mcts();
+
+	Mcts(const Mcts&) = delete;
+	Mcts& operator=(const Mcts&) = delete;
+
+	bool setState(const SearchState& state);
+	unsigned int think(std::chrono::microseconds budget);
+	bool getBestMove(Tetromino& placement, bool& useHold);
+
+	unsigned int getRootVisits() const;
+	unsigned int getFreeNodeCount() const;
+
+protected:
+	enum Expansion : unsigned char
+	{
+		UNEXPANDED,
+		EXPANDING,
+		EXPANDED
+	};
+
+	struct DecisionNode
+	{
+		SearchState state;
+		std::atomic<unsigned int> visits;
+		std::atomic<unsigned char> expansion;
+		unsigned int firstAction;
+
+		// Shapes drawn after the parent action to reach this state, siblings differ only in these
+		std::array<Tetromino::Shape, 2> draws;
+		unsigned char drawCount;
+		unsigned int nextOutcome;
+	};
+
+	struct ActionNode
+	{
+		Position position;
+		Tetromino::Shape shape;
+		bool useHold;
+		int reward;
+		float prior;
+
+		std::atomic<unsigned int> visits;
+		std::atomic<unsigned int> virtualLoss;
+		// Sum of returns in MCTS_VALUE_SCALE fixed point so it can be added atomically
+		std::atomic<long long> valueSum;
+
+		unsigned int nextAction;
+		// Outcome list, only touched while holding outcomeLock
+		unsigned int firstOutcome;
+		std::atomic_flag outcomeLock;
+	};
+
+	struct Worker
+	{
+		MoveGenerator generator;
+		Tetromino piece { 1 };
+		unsigned long long random;
+		std::array<unsigned int, MCTS_MAX_DEPTH> path;
+	};
+
+	std::unique_ptr<DecisionNode[]> m_Decisions;
+	std::unique_ptr<ActionNode[]> m_Actions;
+	unsigned int m_DecisionCapacity;
+	unsigned int m_ActionCapacity;
+
+	// Free node indices, handed out by bumping the counter and rebuilt after every move
+	std::vector<unsigned int> m_FreeDecisions;
+	std::vector<unsigned int> m_FreeActions;
+	std::atomic<unsigned int> m_DecisionTop;
+	std::atomic<unsigned int> m_ActionTop;
+	std::vector<bool> m_DecisionMarks;
+	std::vector<bool> m_ActionMarks;
+
+	unsigned int m_Root = MCTS_NONE;
+
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+	std::vector<std::thread> m_Threads;
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	std::condition_variable m_Done;
+	unsigned int m_Generation = 0;
+	unsigned char m_Busy = 0;
+	bool m_Quit = false;
+	std::chrono::steady_clock::time_point m_Deadline;
+	std::atomic<unsigned int> m_Iterations;
+
+	void runWorker(Worker& worker);
+	void search(Worker& worker);
+	void iterate(Worker& worker);
+	void expand(Worker& worker, unsigned int decision);
+	unsigned int select(DecisionNode& node);
+	unsigned int getOutcome(Worker& worker, ActionNode& action, const SearchState& parent);
+	float rollout(Worker& worker, SearchState state);
+
+	unsigned int allocateDecision(const SearchState& state);
+	unsigned int allocateAction();
+	void refresh(unsigned int decision, const SearchState& state);
+	void mark(unsigned int decision);
+	void collect();
+
+	static void drawMissing(SearchState& state, unsigned long long& random);
+	static float getLeafValue(float evaluation);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+#include "Headers/Rules.hpp"
+
+// Room around the board for the reference mino of pieces sticking out of it
+constexpr unsigned char SEARCH_MARGIN = 4;
+constexpr unsigned char SEARCH_WIDTH = COLUMNS + 2 * SEARCH_MARGIN;
+constexpr unsigned char SEARCH_HEIGHT = ROWS + 2 * SEARCH_MARGIN;
+
+/// @brief Finds every resting placement a piece can reach from where it is, using the same
+/// shifts, SRS rotations and soft drops as a player. Buffers are reused so generation doesn't allocate
+class MoveGenerator
+{
+public:
+	MoveGenerator();
+
+	unsigned short generate(const Matrix& matrix, const Tetromino& tetromino);
+	int find(const std::array<Vector2i, 4>& minos);
+
+	const Tetromino& getPlacement(unsigned short index);
+	unsigned short getPlacementCount();
+
+	static unsigned long long getCellKey(const std::array<Vector2i, 4>& minos);
+
+protected:
+	std::vector<Tetromino> m_Placements;
+	std::vector<unsigned long long> m_PlacementKeys;
+	// Only the position and how the piece got there change during a search, so that is all the queue keeps
+	struct Node
+	{
+		Position position;
+		unsigned char lastKick;
+	};
+
+	std::vector<Node> m_Queue;
+	std::bitset<4 * SEARCH_WIDTH * SEARCH_HEIGHT> m_Visited;
+
+	void visit(const Tetromino& tetromino);
+};
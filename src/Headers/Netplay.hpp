@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Headers/Rollback.hpp"
+
+// Most inputs carried by a single packet, older unacknowledged inputs are resent first
+constexpr unsigned char MAX_PACKET_INPUTS = 64;
+
+/// @brief Exchanges inputs for a RollbackSession with the remote peer over UDP.
+/// Every packet resends all inputs the remote hasn't acknowledged, so lost packets need no retransmission logic
+class NetplayPeer
+{
+public:
+	explicit NetplayPeer(RollbackSession& session);
+
+	bool connect(unsigned short localPort, const sf::IpAddress& remoteAddress, unsigned short remotePort);
+	void receive();
+	void sendInputs();
+
+	int getRoundTripTime();
+
+protected:
+	RollbackSession& m_Session;
+	sf::UdpSocket m_Socket;
+	sf::IpAddress m_RemoteAddress;
+	unsigned short m_RemotePort = 0;
+	sf::Clock m_Clock;
+
+	// Last local frame the remote has confirmed receiving
+	int m_RemoteAckFrame = -1;
+	int m_RemoteFrameAdvantage = 0;
+	sf::Uint32 m_LastRemotePing = 0;
+	int m_RoundTripTime = 0;
+	bool m_DesyncReported = false;
+};
+
+/// @brief Forwards datagrams between two ports after a fixed delay, for testing netplay locally.
+/// Peer A sends to port A and peer B to port B, each side sees the relay as its remote
+class LatencyRelay
+{
+public:
+	LatencyRelay(unsigned short portA, unsigned short portB, unsigned int delayMs, unsigned int jitterMs, unsigned char lossPercent);
+	~LatencyRelay();
+
+	bool start();
+	void stop();
+
+protected:
+	struct Datagram
+	{
+		std::chrono::steady_clock::time_point deliverAt;
+		bool toB;
+		std::size_t size;
+		std::array<char, 512> data;
+	};
+
+	unsigned short m_Ports[2];
+	unsigned int m_DelayMs;
+	unsigned int m_JitterMs;
+	unsigned char m_LossPercent;
+
+	sf::UdpSocket m_Sockets[2];
+	sf::IpAddress m_PeerAddresses[2];
+	unsigned short m_PeerPorts[2] = { 0, 0 };
+
+	std::deque<Datagram> m_Queue;
+	std::atomic<bool> m_Running;
+	std::thread m_Thread;
+
+	void run();
+};
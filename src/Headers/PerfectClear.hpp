@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Headers/SearchState.hpp"
+
+// The field is packed into one 64-bit word, 10 bits per row from the bottom, so at most 6 rows
+constexpr unsigned char PERFECT_CLEAR_MAX_HEIGHT = 6;
+
+struct PerfectClearMove
+{
+	Tetromino::Shape shape;
+	bool useHold;
+	// Board coordinates at the time the piece is placed, as MoveGenerator::find takes them
+	std::array<Vector2i, 4> minos;
+};
+
+/// @brief Depth first search for a sequence of placements that empties the board. Pieces reach their placements by
+/// rotating above the stack, then shifting and soft dropping, which covers hard drops and tucks but not spins.
+/// Failed sub-boards are cached and the first placements are searched in parallel
+class PerfectClear
+{
+public:
+	explicit PerfectClear(unsigned char threadCount = 0);
+
+	bool solve(const SearchState& state, unsigned char maxPieces, unsigned char height, std::vector<PerfectClearMove>& solution);
+
+	unsigned long long getNodeCount() const;
+
+protected:
+	struct Footprint
+	{
+		// Cells relative to the bottom left of the piece, y up
+		std::array<Vector2i, 4> cells;
+		unsigned char width;
+		unsigned char height;
+	};
+
+	struct Placement
+	{
+		unsigned long long cells;
+		// Search order, low placements first
+		unsigned char order;
+		Tetromino::Shape shape;
+		bool useHold;
+		unsigned char nextIndex;
+		unsigned char nextHold;
+	};
+
+	struct Node
+	{
+		unsigned long long board;
+		unsigned char height;
+		unsigned char index;
+		unsigned char hold;
+		unsigned char placed;
+	};
+
+	struct NodeHash
+	{
+		std::size_t operator()(const Node& node) const;
+	};
+
+	struct NodeEqual
+	{
+		bool operator()(const Node& a, const Node& b) const;
+	};
+
+	struct Worker
+	{
+		std::unordered_set<Node, NodeHash, NodeEqual> failures;
+		std::vector<std::vector<Placement>> placements;
+		std::vector<Placement> path;
+		std::vector<unsigned long long> fits;
+		unsigned int branch = 0;
+		unsigned long long nodes = 0;
+	};
+
+	unsigned char m_ThreadCount;
+	std::array<std::vector<Footprint>, 7> m_Footprints;
+	// Cells a shape can cover in a field of each height, by field height and shape
+	std::array<std::array<std::vector<unsigned long long>, 7>, PERFECT_CLEAR_MAX_HEIGHT + 1> m_Coverings;
+
+	// Search input, shared read only by the workers
+	std::array<Tetromino::Shape, SEARCH_QUEUE> m_Queue;
+	unsigned char m_QueueLength;
+	unsigned char m_MaxPieces;
+	std::atomic<int> m_Found;
+	unsigned long long m_Nodes = 0;
+
+	bool searchBranches(const Node& root, const std::vector<Placement>& branches, std::vector<Placement>& path);
+	bool search(Worker& worker, const Node& node, unsigned char depth);
+	void getPlacements(const Node& node, std::vector<Placement>& placements) const;
+	void getPieces(const Node& node, std::vector<Placement>& placements) const;
+	void addPlacements(const Node& node, Tetromino::Shape shape, bool useHold, unsigned char nextIndex, unsigned char nextHold,
+		std::vector<Placement>& placements) const;
+
+	bool hasParityConflict(const Node& node, unsigned char pieces) const;
+	bool hasDeadRegion(const Node& node, std::vector<unsigned long long>& fits) const;
+	static unsigned char getOrder(unsigned long long cells);
+	static Node place(const Node& node, const Placement& placement);
+	static std::array<Vector2i, 4> getMinos(unsigned long long cells);
+};
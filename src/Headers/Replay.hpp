@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Headers/GameSession.hpp"
+
+/// @brief A single player game recorded as its seed and handling plus the input and resulting state hash of every frame
+class Replay
+{
+public:
+	explicit Replay(unsigned long long seed = 0);
+
+	void record(unsigned char input, unsigned long long hash);
+	bool save(const std::string& path);
+	bool load(const std::string& path);
+	int verify(std::ostream& report);
+
+	unsigned long long getSeed();
+	void setHandling(const Handling& handling);
+	const Handling& getHandling();
+	int getFrameCount();
+	unsigned char getInput(int frame);
+	unsigned long long getHash(int frame);
+
+protected:
+	unsigned long long m_Seed;
+	Handling m_Handling;
+	std::vector<unsigned char> m_Inputs;
+	std::vector<unsigned long long> m_Hashes;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Headers/GameSession.hpp"
+
+// Furthest the local simulation may run ahead of the last confirmed remote input
+constexpr unsigned char MAX_ROLLBACK_FRAMES = 8;
+// Frames of input kept for resending and for resimulation
+constexpr unsigned short INPUT_HISTORY = 128;
+// Frames of frame advantage history averaged by the time sync
+constexpr unsigned char TIME_SYNC_WINDOW = 32;
+// Smallest averaged advantage difference worth waiting for
+constexpr unsigned char MIN_FRAME_ADVANTAGE = 2;
+// Largest number of frames the time sync asks to wait at once
+constexpr unsigned char MAX_FRAME_WAIT = 8;
+
+/// @brief Two player lockstep-free session. Remote inputs are predicted, and when a prediction turns out
+/// wrong both games are restored from a snapshot and resimulated with the corrected inputs
+class RollbackSession
+{
+public:
+	RollbackSession(unsigned char localPlayer, unsigned long long seed);
+
+	bool canAdvance();
+	void advanceFrame(unsigned char localInput);
+	void addRemoteInput(int frame, unsigned char input);
+
+	void addRemoteHash(int frame, unsigned long long hash);
+	int checkDesync();
+	void dumpFrame(int frame, std::ostream& out);
+
+	void updateFrameAdvantage(int localAdvantage, int remoteAdvantage);
+	int getRecommendedWaitFrames();
+
+	int getCurrentFrame();
+	int getLastRemoteFrame();
+	int getConfirmedFrame();
+	unsigned long long getFrameHash(int frame);
+	unsigned char getLocalInput(int frame);
+	unsigned char getLocalPlayer();
+	unsigned char getLastRollbackFrames();
+	GameSession& getPlayer(unsigned char player);
+
+protected:
+	struct Snapshot
+	{
+		int frame;
+		GameSession players[2];
+	};
+
+	GameSession m_Players[2];
+	std::array<Snapshot, MAX_ROLLBACK_FRAMES + 2> m_Snapshots;
+
+	std::array<unsigned char, INPUT_HISTORY> m_LocalInputs;
+	// Confirmed remote inputs up to m_LastRemoteFrame, predicted ones after it
+	std::array<unsigned char, INPUT_HISTORY> m_RemoteInputs;
+
+	// Hash of both games after each simulated frame, final once the frame is confirmed
+	std::array<unsigned long long, INPUT_HISTORY> m_Hashes;
+
+	struct RemoteHash
+	{
+		int frame;
+		unsigned long long hash;
+	};
+
+	// Hashes reported by the remote that haven't been compared yet
+	std::array<RemoteHash, INPUT_HISTORY> m_RemoteHashes;
+
+	std::array<signed char, TIME_SYNC_WINDOW> m_LocalAdvantages;
+	std::array<signed char, TIME_SYNC_WINDOW> m_RemoteAdvantages;
+
+	int m_CurrentFrame = 0;
+	int m_LastRemoteFrame = -1;
+	int m_FirstMispredictedFrame = -1;
+	unsigned char m_LocalPlayer;
+	unsigned char m_LastRollbackFrames = 0;
+
+	void simulateFrame(int frame);
+};
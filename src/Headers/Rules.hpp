@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Headers/Board.hpp"
+#include "Headers/Global.hpp"
+#include "Headers/Scoring.hpp"
+#include "Headers/Tetromino.hpp"
+
+// A rule set is a struct of policy types picked at compile time, so a session never branches on its mode:
+//   Rotation   static const std::array<Vector2i, TETROMINO_KICKS>& getKicks(Shape, from, to)
+//   Randomizer static Shape draw(state, size, random), state lives in the piece so sessions stay memcpy-able
+//   Scoring    static ClearType getClearType(matrix, piece) and static int getScore(type, lines, backToBack, combo)
+//   Gravity    static unsigned int getGravity(level), cells per frame in GRAVITY_ONE fixed point
+//   Lock       static constexpr unsigned char DELAY, frames a grounded piece waits after it last fell
+//   Board      a BasicBoard, the matrix size, hidden rows and spawn, see Board.hpp
+
+/// @brief Super Rotation System wall kicks
+struct SrsRotation
+{
+	static const std::array<Vector2i, TETROMINO_KICKS>& getKicks(TetrominoShapes::Shape shape, unsigned char from, unsigned char to);
+};
+
+/// @brief ARS style kicks on the engine's rotation states, one cell right then one left and never for the I
+struct ArsRotation
+{
+	static const std::array<Vector2i, TETROMINO_KICKS>& getKicks(TetrominoShapes::Shape shape, unsigned char from, unsigned char to);
+};
+
+/// @brief No kicks, a rotation that doesn't fit in place fails
+struct ClassicRotation
+{
+	static const std::array<Vector2i, TETROMINO_KICKS>& getKicks(TetrominoShapes::Shape shape, unsigned char from, unsigned char to);
+};
+
+/// @brief Shuffled bags of all seven shapes
+struct SevenBagRandomizer
+{
+	static TetrominoShapes::Shape draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random);
+};
+
+/// @brief TGM history randomizer, rerolls up to four times while the shape is among the last four
+struct TgmRandomizer
+{
+	static TetrominoShapes::Shape draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random);
+};
+
+/// @brief NES randomizer, rerolls once when the shape repeats
+struct NesRandomizer
+{
+	static TetrominoShapes::Shape draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random);
+};
+
+/// @brief Guideline points with T-spins, back to back and combos from SCORE_TABLE
+struct GuidelineScoring
+{
+	template <typename Rules>
+	static ClearType getClearType(const typename BasicTetromino<Rules>::Matrix& matrix, const BasicTetromino<Rules>& tetromino)
+	{
+		return ::getClearType(matrix, tetromino);
+	}
+
+	static int getScore(ClearType type, unsigned char linesCleared, bool backToBack, unsigned char combo)
+	{
+		return SCORE_TABLE[type][linesCleared][backToBack][combo];
+	}
+};
+
+constexpr std::array<int, 5> NES_LINE_SCORES = { 0, 40, 100, 300, 1200 };
+
+/// @brief NES points for the lines alone
+struct NesScoring
+{
+	template <typename Rules>
+	static ClearType getClearType(const typename BasicTetromino<Rules>::Matrix&, const BasicTetromino<Rules>&)
+	{
+		return CLEAR_NORMAL;
+	}
+
+	static int getScore(ClearType, unsigned char linesCleared, bool, unsigned char)
+	{
+		return NES_LINE_SCORES[linesCleared];
+	}
+};
+
+// Gravity is in cells per frame, 16 bits of fraction so the slowest levels still fall on the right frame
+constexpr unsigned int GRAVITY_ONE = 1 << 16;
+// Falling the whole standard board in one frame, anything faster is the same
+constexpr unsigned int MAX_GRAVITY = ROWS * GRAVITY_ONE;
+
+/// @brief Gravity that falls one row every so many frames
+constexpr unsigned int getFrameGravity(double frames)
+{
+	double gravity = GRAVITY_ONE / frames;
+	unsigned int rounded = static_cast<unsigned int>(gravity);
+
+	// Round up so a row still takes exactly that many frames
+	return std::min(rounded < gravity ? rounded + 1 : rounded, MAX_GRAVITY);
+}
+
+/// @brief The same gravity at every level
+template <unsigned char FRAMES>
+struct FixedGravity
+{
+	static constexpr unsigned int getGravity(unsigned char)
+	{
+		return getFrameGravity(FRAMES);
+	}
+};
+
+// NTSC NES frames per row from level 1 up, the last entry holds from there on
+constexpr std::array<unsigned char, 30> NES_FALL_SPEEDS = { 48, 43, 38, 33, 28, 23, 18, 13, 8, 6, 5, 5, 5, 4, 4, 4, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1 };
+
+constexpr std::array<unsigned int, NES_FALL_SPEEDS.size()> makeNesGravity()
+{
+	std::array<unsigned int, NES_FALL_SPEEDS.size()> table {};
+
+	for (unsigned char i = 0; i < NES_FALL_SPEEDS.size(); i++)
+	{
+		table[i] = getFrameGravity(NES_FALL_SPEEDS[i]);
+	}
+
+	return table;
+}
+
+constexpr std::array<unsigned int, NES_FALL_SPEEDS.size()> NES_GRAVITY = makeNesGravity();
+
+struct NesGravity
+{
+	static constexpr unsigned int getGravity(unsigned char level)
+	{
+		return NES_GRAVITY[std::min<unsigned char>(level, NES_GRAVITY.size()) - 1];
+	}
+};
+
+constexpr unsigned char GUIDELINE_GRAVITY_LEVELS = 20;
+
+/// @brief Guideline curve, (0.8 - (level - 1) * 0.007) ^ (level - 1) seconds per row, which reaches 20G at level 19
+constexpr std::array<unsigned int, GUIDELINE_GRAVITY_LEVELS> makeGuidelineGravity()
+{
+	std::array<unsigned int, GUIDELINE_GRAVITY_LEVELS> table {};
+
+	for (unsigned char level = 1; level <= GUIDELINE_GRAVITY_LEVELS; level++)
+	{
+		double seconds = 1;
+
+		for (unsigned char i = 1; i < level; i++)
+		{
+			seconds *= 0.8 - (level - 1) * 0.007;
+		}
+
+		table[level - 1] = getFrameGravity(seconds * 1000000 / FRAME_DURATION);
+	}
+
+	return table;
+}
+
+constexpr std::array<unsigned int, GUIDELINE_GRAVITY_LEVELS> GUIDELINE_GRAVITY = makeGuidelineGravity();
+
+struct GuidelineGravity
+{
+	static constexpr unsigned int getGravity(unsigned char level)
+	{
+		return GUIDELINE_GRAVITY[std::min(level, GUIDELINE_GRAVITY_LEVELS) - 1];
+	}
+};
+
+/// @brief Grounded pieces lock on the first gravity step at least FRAMES frames after they last fell, hard drops lock at once
+template <unsigned char FRAMES>
+struct DelayLock
+{
+	static constexpr unsigned char DELAY = FRAMES;
+};
+
+using InstantLock = DelayLock<0>;
+
+/// @brief The rules the game plays by, used by every bot and tool
+struct GuidelineRules
+{
+	using Rotation = SrsRotation;
+	using Randomizer = SevenBagRandomizer;
+	using Scoring = GuidelineScoring;
+	using Gravity = GuidelineGravity;
+	using Lock = DelayLock<30>;
+	using Board = StandardBoard;
+};
+
+struct ClassicRules
+{
+	using Rotation = ClassicRotation;
+	using Randomizer = NesRandomizer;
+	using Scoring = NesScoring;
+	using Gravity = NesGravity;
+	using Lock = InstantLock;
+	using Board = StandardBoard;
+};
+
+struct TgmRules
+{
+	using Rotation = ArsRotation;
+	using Randomizer = TgmRandomizer;
+	using Scoring = NesScoring;
+	using Gravity = FixedGravity<START_FALL_SPEED>;
+	using Lock = DelayLock<30>;
+	using Board = StandardBoard;
+};
+
+/// @brief Guideline play in a 4 wide well
+struct FourWideRules : GuidelineRules
+{
+	using Board = BasicBoard<4, VISIBLE_ROWS, BUFFER_ROWS>;
+};
+
+/// @brief Guideline play on a 16 wide board
+struct SixteenWideRules : GuidelineRules
+{
+	using Board = BasicBoard<16, VISIBLE_ROWS, BUFFER_ROWS>;
+};
+
+/// @brief Guideline play with 20 hidden rows over the field, 40 in all
+struct TallRules : GuidelineRules
+{
+	using Board = BasicBoard<COLUMNS, VISIBLE_ROWS, 20>;
+};
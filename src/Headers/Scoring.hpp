@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+#include "Headers/Tetromino.hpp"
+
+enum ClearType : unsigned char
+{
+	CLEAR_NORMAL,
+	CLEAR_TSPIN_MINI,
+	CLEAR_TSPIN
+};
+
+constexpr unsigned char CLEAR_TYPES = 3;
+// Combos longer than this score like the last entry
+constexpr unsigned char SCORE_COMBO_LIMIT = 32;
+
+// Points at level 1, indexed by clear type, lines cleared, back to back and combo
+using ScoreTable = std::array<std::array<std::array<std::array<int, SCORE_COMBO_LIMIT>, 2>, 5>, CLEAR_TYPES>;
+
+constexpr bool isDifficultClear(ClearType type, unsigned char lines)
+{
+	return lines == 4 || (type != CLEAR_NORMAL && lines > 0);
+}
+
+/// @brief Guideline scoring. Tetrises and T-spins that clear lines are difficult and get half again on top when the
+/// previous clear was difficult too, every clear in a combo after the first adds 50 per step
+constexpr ScoreTable makeScoreTable()
+{
+	// A mini can't clear three lines, so those entries are never read
+	constexpr int baseScores[CLEAR_TYPES][5] = { { 0, 100, 300, 500, 800 }, { 100, 200, 400, 0, 0 }, { 400, 800, 1200, 1600, 0 } };
+
+	ScoreTable table {};
+
+	for (unsigned char type = 0; type < CLEAR_TYPES; type++)
+	{
+		for (unsigned char lines = 0; lines < 5; lines++)
+		{
+			bool difficult = isDifficultClear(static_cast<ClearType>(type), lines);
+
+			for (unsigned char backToBack = 0; backToBack < 2; backToBack++)
+			{
+				for (unsigned char combo = 0; combo < SCORE_COMBO_LIMIT; combo++)
+				{
+					int score = baseScores[type][lines];
+
+					if (difficult && backToBack)
+					{
+						score += score / 2;
+					}
+
+					if (lines > 0)
+					{
+						score += 50 * combo;
+					}
+
+					table[type][lines][backToBack][combo] = score;
+				}
+			}
+		}
+	}
+
+	return table;
+}
+
+constexpr ScoreTable SCORE_TABLE = makeScoreTable();
+
+// Corners around the T's center, clockwise from the top left so the two in front of rotation r are bits r and r + 1
+using TSpinTable = std::array<std::array<std::array<ClearType, 16>, 4>, 2>;
+
+/// @brief 3-corner rule. Three occupied corners make a T-spin, which is only a mini unless both corners the T points
+/// at are among them or the rotation needed the last SRS kick. Indexed by last kick, rotation and corner mask
+constexpr TSpinTable makeTSpinTable()
+{
+	TSpinTable table {};
+
+	for (unsigned char lastKick = 0; lastKick < 2; lastKick++)
+	{
+		for (unsigned char rotation = 0; rotation < 4; rotation++)
+		{
+			unsigned char front = (1 << rotation) | (1 << ((rotation + 1) % 4));
+
+			for (unsigned char corners = 0; corners < 16; corners++)
+			{
+				unsigned char count = (corners & 1) + ((corners >> 1) & 1) + ((corners >> 2) & 1) + ((corners >> 3) & 1);
+
+				if (count < 3)
+				{
+					table[lastKick][rotation][corners] = CLEAR_NORMAL;
+				}
+				else if ((corners & front) == front || lastKick)
+				{
+					table[lastKick][rotation][corners] = CLEAR_TSPIN;
+				}
+				else
+				{
+					table[lastKick][rotation][corners] = CLEAR_TSPIN_MINI;
+				}
+			}
+		}
+	}
+
+	return table;
+}
+
+constexpr TSpinTable T_SPIN_TABLE = makeTSpinTable();
+
+/// @brief Classifies a piece about to lock. Only a T whose last successful move was a rotation can spin
+template <typename Rules>
+ClearType getClearType(const typename BasicTetromino<Rules>::Matrix& matrix, const BasicTetromino<Rules>& tetromino)
+{
+	if (tetromino.getShape() != TetrominoShapes::Shape::T || tetromino.getLastKick() == 0)
+	{
+		return CLEAR_NORMAL;
+	}
+
+	constexpr Vector2i offsets[4] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+	Vector2i center = tetromino.getMinos()[0];
+	unsigned char corners = 0;
+
+	for (unsigned char i = 0; i < 4; i++)
+	{
+		Vector2i corner = center + offsets[i];
+
+		// Walls and floor count as occupied, the space above the board doesn't
+		corners |= BasicTetromino<Rules>::Board::isBlocked(matrix, corner.x, corner.y) << i;
+	}
+
+	return T_SPIN_TABLE[tetromino.getLastKick() == TETROMINO_KICKS][tetromino.getRotation()][corners];
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+
+// Known upcoming pieces a search state can hold, the current piece included
+constexpr unsigned char SEARCH_QUEUE = 12;
+constexpr unsigned char NO_HOLD = 7;
+constexpr unsigned char FULL_BAG = 0x7F;
+
+/// @brief Placement level game state for search. Unlike GameSession it doesn't carry the RNG, only what a player
+/// can know: the board, the visible queue, hold and which shapes are left in the 7-bag
+struct SearchState
+{
+	Matrix matrix;
+	std::array<Tetromino::Shape, SEARCH_QUEUE> queue;
+	unsigned char queueLength;
+	unsigned char hold;
+	// Shapes left in the bag after the last queued piece, bit n for Shape n
+	unsigned char bag;
+	unsigned char level;
+
+	static SearchState fromSession(const GameSession& session);
+
+	bool getPiece(bool useHold, Tetromino& piece) const;
+	int apply(const std::array<Vector2i, 4>& minos, Tetromino::Shape shape, bool useHold);
+
+	unsigned char getDrawMask() const;
+	void draw(Tetromino::Shape shape);
+	Tetromino::Shape drawRandom(unsigned long long& random);
+
+	unsigned long long hash() const;
+	bool operator==(const SearchState& other) const;
+};
+
+static_assert(std::is_trivially_copyable<SearchState>::value, "SearchState is copied and compared as raw bytes");
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Headers/AssetArchive.hpp"
+#include "Headers/AudioEngine.hpp"
+
+// Sounds that can play at once, the one started longest ago is cut off for a new one
+constexpr unsigned char AUDIO_VOICES = 8;
+
+/// @brief Plays the effects through a fixed pool of SFML voices. Each effect is read from sounds/<name>.wav in the asset
+/// archive or content/ if present, otherwise a short tone is synthesized for it, and either way it is decoded before the
+/// game starts
+class SfmlAudioOutput : public IAudioOutput
+{
+public:
+	explicit SfmlAudioOutput(const AssetArchive& assets);
+
+	bool load() final;
+	void play(SoundEffect effect) final;
+
+protected:
+	const AssetArchive& m_Assets;
+	std::array<sf::SoundBuffer, SOUND_EFFECTS> m_Buffers;
+	std::array<sf::Sound, AUDIO_VOICES> m_Voices;
+	unsigned char m_NextVoice = 0;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef __linux__
+struct ShmRingHeader;
+
+/// @brief Single producer, single consumer ring of fixed size slots in POSIX shared memory. Indices are lock-free
+/// atomics and a side that finds the ring full or empty spins briefly, then sleeps on a futex until the other wakes it.
+/// Each side attaches its own ShmRing, one only writes and the other only reads
+class ShmRing
+{
+public:
+	ShmRing() = default;
+	ShmRing(const ShmRing&) = delete;
+	ShmRing& operator=(const ShmRing&) = delete;
+	~ShmRing();
+
+	bool create(const std::string& name, unsigned int slotSize, unsigned int capacity);
+	bool open(const std::string& name);
+	void close();
+	void detach();
+
+	void* beginWrite();
+	void endWrite();
+	const void* beginRead();
+	void endRead();
+
+	bool push(const void* data);
+	bool pop(void* data);
+
+	unsigned int getSlotSize() const;
+	unsigned int getCapacity() const;
+
+protected:
+	ShmRingHeader* m_Header = nullptr;
+	unsigned char* m_Slots = nullptr;
+	std::size_t m_MappedSize = 0;
+	std::size_t m_SlotStride = 0;
+	std::string m_Name;
+	bool m_Owner = false;
+
+	// Each side's own index plus its last look at the other side's, to keep cache lines from bouncing
+	unsigned int m_Position = 0;
+	unsigned int m_CachedOther = 0;
+
+	bool map(int descriptor, std::size_t size);
+};
+#endif // __linux__
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+
+// Stages marked after the last one fits are dropped
+constexpr unsigned char STARTUP_STAGES = 16;
+
+/// @brief When each part of startup finished, relative to launch. Any thread can mark a stage, the report lists them
+/// in the order they finished with the time each took after the one before
+class StartupTimeline
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit StartupTimeline(Clock::time_point launch);
+
+	void mark(const char* stage);
+	void mark(const char* stage, Clock::time_point time);
+
+	unsigned char getStageCount() const;
+	double getElapsed(const std::string& stage) const;
+	void report(std::ostream& out) const;
+
+protected:
+	struct Stage
+	{
+		const char* name;
+		Clock::time_point time;
+	};
+
+	Clock::time_point m_Launch;
+	mutable std::mutex m_Mutex;
+	std::array<Stage, STARTUP_STAGES> m_Stages {};
+	unsigned char m_Count = 0;
+};
@@ -0,0 +1,100 @@
+#ifndef TETRIS_CORE_H
+#define TETRIS_CORE_H
+
+/*
+ * C interface to the game engine, built as libtetriscore without SFML.
+ * All buffers are owned by the caller and nothing is copied behind its back.
+ * Bump TETRIS_CORE_ABI_VERSION whenever a signature or a layout below changes.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+	#define TETRIS_API __declspec(dllexport)
+#else
+	#define TETRIS_API __attribute__((visibility("default")))
+#endif
+
+#define TETRIS_CORE_ABI_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TetrisSession TetrisSession;
+typedef struct TetrisVecEnv TetrisVecEnv;
+typedef struct TetrisRing TetrisRing;
+
+/* A reachable resting position of the active piece, cells are (x, y) with y counted down from the top */
+typedef struct TetrisPlacement
+{
+	uint8_t shape;
+	uint8_t rotation;
+	int8_t cells[4][2];
+} TetrisPlacement;
+
+enum
+{
+	TETRIS_BOARD_COLUMNS = 10,
+	/* 20 visible rows under 4 hidden ones */
+	TETRIS_BOARD_ROWS = 24,
+	TETRIS_MAX_PLACEMENTS = 4 * TETRIS_BOARD_COLUMNS * TETRIS_BOARD_ROWS
+};
+
+TETRIS_API uint32_t tetris_abi_version(void);
+
+/* Sessions: one game driven by per frame inputs (see the Input bits in Global.hpp) or by whole placements */
+TETRIS_API TetrisSession* tetris_session_create(uint64_t seed);
+TETRIS_API void tetris_session_destroy(TetrisSession* session);
+TETRIS_API void tetris_session_step(TetrisSession* session, const uint8_t* inputs, uint32_t frames);
+TETRIS_API uint8_t tetris_session_state(const TetrisSession* session);
+TETRIS_API int32_t tetris_session_score(const TetrisSession* session);
+TETRIS_API int32_t tetris_session_lines(const TetrisSession* session);
+TETRIS_API uint64_t tetris_session_hash(const TetrisSession* session);
+
+/* Snapshots are opaque blobs of tetris_snapshot_size() bytes */
+TETRIS_API uint32_t tetris_snapshot_size(void);
+TETRIS_API void tetris_session_snapshot(const TetrisSession* session, void* snapshot);
+TETRIS_API void tetris_session_restore(TetrisSession* session, const void* snapshot);
+
+/* Writes TETRIS_BOARD_ROWS * TETRIS_BOARD_COLUMNS cells, row major from the top of the hidden rows, 0 empty and 1 + shape otherwise */
+TETRIS_API void tetris_session_board(const TetrisSession* session, uint8_t* cells);
+
+/* Move generation for the active piece, returns the number written to placements (at most capacity) */
+TETRIS_API uint32_t tetris_session_placements(TetrisSession* session, TetrisPlacement* placements, uint32_t capacity);
+/* Locks a placement from the last tetris_session_placements call. Returns 1 while the game goes on, 0 once it is
+ * over and -1 if the index is not a current placement. Stepping, restoring, placing and holding all invalidate placements */
+TETRIS_API int32_t tetris_session_place(TetrisSession* session, uint32_t index);
+/* Returns 1 if the hold was allowed */
+TETRIS_API int32_t tetris_session_hold(TetrisSession* session);
+
+/* Batched training environment, see VecEnv.hpp for the action and observation layout */
+TETRIS_API TetrisVecEnv* tetris_vecenv_create(uint32_t count, uint64_t seed, uint32_t max_pieces);
+TETRIS_API void tetris_vecenv_destroy(TetrisVecEnv* env);
+TETRIS_API uint32_t tetris_vecenv_observation_size(void);
+TETRIS_API uint32_t tetris_vecenv_action_count(void);
+TETRIS_API void tetris_vecenv_reset(TetrisVecEnv* env, uint8_t* observations);
+TETRIS_API void tetris_vecenv_step(TetrisVecEnv* env, const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+
+#ifdef __linux__
+/* Shared memory rings (see ShmRing.hpp) for feeding a trainer in another process. Slots hold tetris_transition_size()
+ * bytes for transition rings. begin calls block while the ring is full or empty and return NULL once it is closed */
+TETRIS_API TetrisRing* tetris_ring_create(const char* name, uint32_t slot_size, uint32_t capacity);
+TETRIS_API TetrisRing* tetris_ring_open(const char* name);
+TETRIS_API void tetris_ring_close(TetrisRing* ring);
+TETRIS_API void tetris_ring_destroy(TetrisRing* ring);
+TETRIS_API void* tetris_ring_begin_write(TetrisRing* ring);
+TETRIS_API void tetris_ring_end_write(TetrisRing* ring);
+TETRIS_API const void* tetris_ring_begin_read(TetrisRing* ring);
+TETRIS_API void tetris_ring_end_read(TetrisRing* ring);
+
+/* Steps every game and writes each transition straight into a ring slot, returns 0 if the ring was closed */
+TETRIS_API uint32_t tetris_transition_size(void);
+TETRIS_API int32_t tetris_vecenv_step_to_ring(TetrisVecEnv* env, const uint8_t* actions, TetrisRing* ring);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TETRIS_CORE_H
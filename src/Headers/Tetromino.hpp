@@ -1,8 +1,13 @@
 #pragma once
 
-class Tetromino
+#include "Headers/Global.hpp"
+
+// Most offsets a rotation system tries per rotation
+constexpr unsigned char TETROMINO_KICKS = 5;
+
+/// @brief Shapes shared by the pieces of every rule set
+struct TetrominoShapes
 {
-public:
 	enum Shape : unsigned char
 	{
 		I,
@@ -13,43 +18,145 @@ public:
 		T,
 		Z
 	};
+};
 
-	Tetromino();
+// Mino offsets from the piece's origin by shape and rotation. Rotation 0 is the spawn orientation, every other
+// turns the one before clockwise: about the first mino, or for the I about the center of its 4x4 box
+using FootprintTable = std::array<std::array<std::array<Vector2i, 4>, 4>, 7>;
 
-	bool moveDown(const std::vector<std::vector<unsigned char>>& matrix);
-	bool reset(const std::vector<std::vector<unsigned char>>& matrix);
-	bool reset(Tetromino::Shape shape, const std::vector<std::vector<unsigned char>>& matrix);
+constexpr FootprintTable makeFootprints()
+{
+	// Spawn orientations in Shape order, the origin is where a new piece is centered
+	constexpr Vector2i spawnOffsets[7][4] = {
+		{ { 1, -1 }, { 0, -1 }, { -1, -1 }, { -2, -1 } },
+		{ { 0, 0 }, { 1, 0 }, { -1, -1 }, { -1, 0 } },
+		{ { 0, 0 }, { 1, 0 }, { 1, -1 }, { -1, 0 } },
+		{ { 0, 0 }, { 0, -1 }, { -1, -1 }, { -1, 0 } },
+		{ { 0, 0 }, { 1, -1 }, { 0, -1 }, { -1, 0 } },
+		{ { 0, 1 }, { 0, 0 }, { -1, 1 }, { 1, 1 } },
+		{ { 0, 0 }, { 1, 0 }, { 0, -1 }, { -1, -1 } }
+	};
 
-	Tetromino::Shape getShape();
-	Tetromino::Shape getNextShape();
-	Tetromino::Shape getHoldingShape();
-	std::vector<sf::Vector2i> getNextShapeTetromino(unsigned char x, unsigned char y);
+	FootprintTable table {};
 
-	int hardDrop(std::vector<std::vector<unsigned char>>& matrix);
-	void moveLeft(const std::vector<std::vector<unsigned char>>& matrix);
-	void moveRight(const std::vector<std::vector<unsigned char>>& matrix);
-	void rotate(bool clockwise, const std::vector<std::vector<unsigned char>>& matrix);
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		for (unsigned char i = 0; i < 4; i++)
+		{
+			table[shape][0][i] = spawnOffsets[shape][i];
+		}
 
-	void updateMatrix(std::vector<std::vector<unsigned char>>& matrix);
+		for (unsigned char rotation = 1; rotation < 4; rotation++)
+		{
+			const std::array<Vector2i, 4>& previous = table[shape][rotation - 1];
 
-	unsigned char getRotation();
-	bool isHolding();
-	std::vector<sf::Vector2i> getGhostMinos(const std::vector<std::vector<unsigned char>>& matrix);
-	std::vector<sf::Vector2i> getMinos();
-	std::vector<sf::Vector2i> getHoldMinos(unsigned char x, unsigned char y);
-	std::vector<sf::Vector2i> getWallKickData(unsigned char nextRotation);
-	void processHoldSwap(std::vector<std::vector<unsigned char>>& matrix);
+			if (shape == TetrominoShapes::Shape::O)
+			{
+				table[shape][rotation] = previous;
+			}
+			else if (shape == TetrominoShapes::Shape::I)
+			{
+				// The center sits between cells, so work in doubled coordinates to stay in integers
+				constexpr Vector2i centerOffsets[4] = { { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 0 } };
+				int centerX = previous[1].x + previous[2].x + centerOffsets[rotation - 1].x;
+				int centerY = previous[1].y + previous[2].y + centerOffsets[rotation - 1].y;
+
+				for (unsigned char i = 0; i < 4; i++)
+				{
+					int x = 2 * previous[i].x - centerX;
+					int y = 2 * previous[i].y - centerY;
+					table[shape][rotation][i] = Vector2i((centerX - y) / 2, (centerY + x) / 2);
+				}
+			}
+			else
+			{
+				for (unsigned char i = 0; i < 4; i++)
+				{
+					Vector2i offset = previous[i] - previous[0];
+					table[shape][rotation][i] = previous[0] + Vector2i(-offset.y, offset.x);
+				}
+			}
+		}
+	}
+
+	return table;
+}
+
+constexpr FootprintTable TETROMINO_FOOTPRINTS = makeFootprints();
+
+/// @brief The falling piece along with its preview, hold and randomizer. Rules picks the rotation system,
+/// randomizer and board at compile time, see Rules.hpp. The piece itself is its shape and a packed Position, 4 bytes
+/// that search and snapshots can copy around, its minos come out of TETROMINO_FOOTPRINTS
+template <typename Rules>
+class BasicTetromino : public TetrominoShapes
+{
+public:
+	// The rule set's board, member functions see these rather than the standard board's
+	using Board = typename Rules::Board;
+	using Matrix = typename Board::Matrix;
+	static constexpr unsigned char COLUMNS = Board::COLUMNS;
+	static constexpr unsigned char ROWS = Board::ROWS;
+
+	BasicTetromino();
+	explicit BasicTetromino(unsigned long long seed);
+
+	bool moveDown(const Matrix& matrix);
+	unsigned char fall(unsigned char rows, const Matrix& matrix);
+	unsigned char getDropDistance(const Matrix& matrix) const;
+	bool reset(const Matrix& matrix);
+	bool reset(Shape shape, const Matrix& matrix);
+
+	Shape getShape() const;
+	Shape getNextShape() const;
+	Shape getHoldingShape() const;
+	std::array<Vector2i, 4> getNextShapeTetromino(unsigned char x, unsigned char y);
+
+	int hardDrop(Matrix& matrix);
+	void moveLeft(const Matrix& matrix);
+	void moveRight(const Matrix& matrix);
+	unsigned char shift(signed char direction, unsigned char columns, const Matrix& matrix);
+	unsigned char getShiftDistance(signed char direction, const Matrix& matrix) const;
+	void rotate(bool clockwise, const Matrix& matrix);
+
+	void updateMatrix(Matrix& matrix);
+
+	unsigned char getRotation() const;
+	unsigned char getLastKick() const;
+	bool isHolding() const;
+	unsigned char getBagMask() const;
+	std::array<Vector2i, 4> getGhostMinos(const Matrix& matrix);
+	std::array<Vector2i, 4> getMinos() const;
+	Position getPosition() const;
+	void setPosition(Position position, unsigned char lastKick = 0);
+	std::array<Vector2i, 4> getHoldMinos(unsigned char x, unsigned char y);
+	const std::array<Vector2i, TETROMINO_KICKS>& getWallKickData(unsigned char nextRotation);
+	void processHoldSwap(Matrix& matrix);
+
+	unsigned long long hash(unsigned long long hash) const;
+
+	static std::array<Vector2i, 4> getMinos(Shape shape, Position position);
 
 protected:
-	unsigned char m_Rotation;
-	Tetromino::Shape m_Shape;
-	Tetromino::Shape m_NextShape;
-	Tetromino::Shape m_HoldShape;
+	Position m_Position;
+	Shape m_Shape;
+	Shape m_NextShape;
+	Shape m_HoldShape;
 	bool m_IsHolding = false;
-	std::default_random_engine m_Random;
 
-	std::vector<sf::Vector2i> m_Minos;
+	// Randomizer state, the remaining shapes of the current 7-bag or the history of randomizers that keep one
+	std::array<Shape, 7> m_Bag {};
+	unsigned char m_BagSize = 0;
+
+	// 1 + the kick offset used if the last successful move was a rotation, 0 otherwise
+	unsigned char m_LastKick = 0;
 
-	std::vector<sf::Vector2i> getTetromino(Shape shape, unsigned char x, unsigned char y);
-	Tetromino::Shape selectRandomShape();
+	// xorshift64* state, kept inline so the piece can be copied with memcpy
+	unsigned long long m_Random;
+
+	std::array<Vector2i, 4> getTetromino(Shape shape, unsigned char x, unsigned char y);
+	Shape selectRandomShape();
 };
+
+struct GuidelineRules;
+
+using Tetromino = BasicTetromino<GuidelineRules>;
@@ -0,0 +1,49 @@
+#pragma once
+
+/// @brief Lock-free hand-off of the latest value from one producer thread to one consumer thread. The producer fills the
+/// back slot and publishes it, the consumer swaps in whatever was published last. Neither side ever waits, and values
+/// published faster than they are read are skipped
+template <typename T>
+class TripleBuffer
+{
+public:
+	/// @brief The slot the producer writes, only valid until the next publish
+	T& getBack()
+	{
+		return m_Slots[m_Back];
+	}
+
+	void publish()
+	{
+		m_Back = m_Middle.exchange(m_Back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	/// @brief Swaps the last published value into the front slot, returns false if nothing new was published
+	bool update()
+	{
+		if ((m_Middle.load(std::memory_order_relaxed) & FRESH) == 0)
+		{
+			return false;
+		}
+
+		m_Front = m_Middle.exchange(m_Front, std::memory_order_acq_rel) & INDEX;
+
+		return true;
+	}
+
+	/// @brief The slot the consumer reads, only valid until the next update
+	T& getFront()
+	{
+		return m_Slots[m_Front];
+	}
+
+protected:
+	// The middle slot index, with a flag set while it holds a value the consumer hasn't taken
+	static constexpr unsigned char INDEX = 3;
+	static constexpr unsigned char FRESH = 4;
+
+	std::array<T, 3> m_Slots {};
+	unsigned char m_Back = 0;
+	alignas(64) std::atomic<unsigned char> m_Middle { 1 };
+	alignas(64) unsigned char m_Front = 2;
+};
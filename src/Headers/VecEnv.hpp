@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Headers/Board.hpp"
+#include "Headers/Global.hpp"
+#include "Headers/Rules.hpp"
+
+constexpr unsigned char VECENV_PREVIEWS = 5;
+
+// Action = hold * 4 * COLUMNS + rotation * COLUMNS + column of the piece's leftmost mino, then hard drop
+constexpr unsigned short VECENV_ACTIONS = 2 * 4 * COLUMNS;
+
+// Observation bytes per game: board cells (0/1, row major from the top), current piece one-hot, hold one-hot
+// with a trailing "empty" slot, previews one-hot, then the legal action mask
+constexpr unsigned short VECENV_BOARD_OFFSET = 0;
+constexpr unsigned short VECENV_PIECE_OFFSET = VECENV_BOARD_OFFSET + ROWS * COLUMNS;
+constexpr unsigned short VECENV_HOLD_OFFSET = VECENV_PIECE_OFFSET + 7;
+constexpr unsigned short VECENV_PREVIEW_OFFSET = VECENV_HOLD_OFFSET + 8;
+constexpr unsigned short VECENV_MASK_OFFSET = VECENV_PREVIEW_OFFSET + 7 * VECENV_PREVIEWS;
+constexpr unsigned short VECENV_OBSERVATION_SIZE = VECENV_MASK_OFFSET + VECENV_ACTIONS;
+
+/// @brief Fixed layout record of one game's step, for streaming transitions one at a time to another process
+struct Transition
+{
+	unsigned int env;
+	float reward;
+	unsigned char done;
+	unsigned char action;
+	unsigned char observation[VECENV_OBSERVATION_SIZE];
+};
+
+static_assert(std::is_trivially_copyable<Transition>::value, "Transitions are copied between processes as raw bytes");
+
+/// @brief Many independent games stepped together with placement actions, for training. State is kept as
+/// structure of arrays with the board as one bitmask per row, and results are written straight into caller buffers
+class VecEnv
+{
+public:
+	VecEnv(unsigned int count, unsigned long long seed, unsigned int maxPieces = 0);
+
+	void reset(unsigned char* observations);
+	void step(const unsigned char* actions, unsigned char* observations, float* rewards, unsigned char* dones);
+	void step(unsigned int env, unsigned char action, Transition& transition);
+
+	unsigned int getCount() const;
+	int getScore(unsigned int env) const;
+	int getLinesCleared(unsigned int env) const;
+	Matrix getMatrix(unsigned int env) const;
+
+protected:
+	unsigned int m_Count;
+	unsigned int m_MaxPieces;
+	unsigned long long m_SeedStream;
+
+	// Bit x of row y is set when matrix[x][y] would be filled
+	std::vector<std::array<StandardBoard::Row, ROWS>> m_Boards;
+	// Only used as a source of shapes so the bag matches the game exactly
+	std::vector<Tetromino> m_Randomizers;
+	std::vector<std::array<Tetromino::Shape, VECENV_PREVIEWS + 1>> m_Queues;
+	std::vector<unsigned char> m_Holds;
+	std::vector<int> m_Scores;
+	std::vector<int> m_Lines;
+	std::vector<unsigned int> m_Pieces;
+
+	bool stepEnv(unsigned int env, unsigned char action, unsigned char* observation, float& reward);
+	void resetEnv(unsigned int env);
+	Tetromino::Shape drawShape(unsigned int env);
+	int place(unsigned int env, unsigned char action);
+	unsigned char getFirstLegalAction(unsigned int env) const;
+	bool canSpawn(unsigned int env) const;
+	void writeObservation(unsigned int env, unsigned char* observation) const;
+};
@@ -0,0 +1,91 @@
+#include "Headers/Heuristic.hpp"
+#include "Headers/Scoring.hpp"
+
+/// @brief Writes a piece into the board and collapses any rows it completes, returns how many
+unsigned char Heuristic::lock(Matrix& matrix, const std::array<Vector2i, 4>& minos, unsigned char cell)
+{
+	for (const Vector2i& mino : minos)
+	{
+		if (mino.x >= 0 && mino.x < COLUMNS && mino.y >= 0 && mino.y < ROWS)
+		{
+			matrix[mino.x][mino.y] = cell;
+		}
+	}
+
+	unsigned char linesCleared = 0;
+
+	for (unsigned char y = 0; y < ROWS; y++)
+	{
+		bool full = true;
+
+		for (unsigned char x = 0; x < COLUMNS && full; x++)
+		{
+			full = matrix[x][y] != 0;
+		}
+
+		if (!full)
+		{
+			continue;
+		}
+
+		linesCleared++;
+
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			for (unsigned char i = y; i > 0; i--)
+			{
+				matrix[x][i] = matrix[x][i - 1];
+			}
+
+			matrix[x][0] = 0;
+		}
+	}
+
+	return linesCleared;
+}
+
+/// @brief Classic hand tuned weights on height, holes and bumpiness
+float Heuristic::evaluate(const Matrix& matrix, unsigned char linesCleared)
+{
+	int aggregateHeight = 0;
+	int holes = 0;
+	int bumpiness = 0;
+	int previousHeight = -1;
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		int height = 0;
+
+		for (unsigned char y = 0; y < ROWS; y++)
+		{
+			if (matrix[x][y] != 0)
+			{
+				if (height == 0)
+				{
+					height = ROWS - y;
+				}
+			}
+			else if (height > 0)
+			{
+				holes++;
+			}
+		}
+
+		aggregateHeight += height;
+
+		if (previousHeight >= 0)
+		{
+			bumpiness += std::abs(height - previousHeight);
+		}
+
+		previousHeight = height;
+	}
+
+	return -0.51f * aggregateHeight + HEURISTIC_LINES_WEIGHT * linesCleared - 0.36f * holes - 0.18f * bumpiness;
+}
+
+/// @brief Same table as GameSession::removeClearedLines
+int Heuristic::getLineClearScore(unsigned char linesCleared, int level)
+{
+	return SCORE_TABLE[CLEAR_NORMAL][std::min<unsigned char>(linesCleared, 4)][0][0] * level;
+}
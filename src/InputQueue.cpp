@@ -0,0 +1,59 @@
+#include "Headers/InputQueue.hpp"
+
+/// @brief Queues a press or release of the input bits, events are expected in time order
+void InputQueue::push(unsigned char bits, bool pressed, Clock::time_point time)
+{
+	if (bits == 0)
+	{
+		return;
+	}
+
+	if (m_Count == INPUT_QUEUE_SIZE)
+	{
+		apply(m_Events[m_Head]);
+		m_Head = (m_Head + 1) % INPUT_QUEUE_SIZE;
+		m_Count--;
+	}
+
+	m_Events[(m_Head + m_Count) % INPUT_QUEUE_SIZE] = { time, bits, pressed };
+	m_Count++;
+}
+
+/// @brief Applies every event before the end of the frame and returns its input, the held keys plus anything pressed
+/// during the frame. Later events stay queued for the frames they belong to
+unsigned char InputQueue::popFrame(Clock::time_point frameEnd)
+{
+	while (m_Count > 0 && m_Events[m_Head].time < frameEnd)
+	{
+		apply(m_Events[m_Head]);
+		m_Head = (m_Head + 1) % INPUT_QUEUE_SIZE;
+		m_Count--;
+	}
+
+	unsigned char input = m_Held | m_Tapped;
+	m_Tapped = 0;
+
+	return input;
+}
+
+/// @brief Drops queued events and releases everything, for when the window loses focus
+void InputQueue::clear()
+{
+	m_Head = 0;
+	m_Count = 0;
+	m_Held = 0;
+	m_Tapped = 0;
+}
+
+void InputQueue::apply(const Event& event)
+{
+	if (event.pressed)
+	{
+		m_Held |= event.bits;
+		m_Tapped |= event.bits;
+	}
+	else
+	{
+		m_Held &= ~event.bits;
+	}
+}
@@ -0,0 +1,169 @@
+#include "Headers/LatencyProbe.hpp"
+
+namespace
+{
+unsigned int getMicroseconds(LatencyProbe::Clock::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}
+
+/// @brief Starts following a press of each input bit, stamped when the event was polled
+void LatencyProbe::received(unsigned char bits, Clock::time_point time)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (unsigned char kind = 0; kind < LATENCY_KINDS; kind++)
+	{
+		if (bits & (1 << kind))
+		{
+			m_Pending.push_back({ time, time, time, kind, 0 });
+		}
+	}
+}
+
+/// @brief A logic frame ran with the events before its end, the same ones InputQueue::popFrame hands it
+void LatencyProbe::consumed(Clock::time_point frameEnd, Clock::time_point time)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (Sample& sample : m_Pending)
+	{
+		if (sample.stages == 0 && sample.received < frameEnd)
+		{
+			sample.consumed = time;
+			sample.stages = LATENCY_CONSUMED + 1;
+			m_Latencies[sample.kind][LATENCY_CONSUMED].push_back(getMicroseconds(time - sample.received));
+		}
+	}
+}
+
+/// @brief The frame ending at frameEnd was drawn, which shows every press its logic frame consumed
+void LatencyProbe::drawn(Clock::time_point frameEnd, Clock::time_point time)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (Sample& sample : m_Pending)
+	{
+		if (sample.stages == LATENCY_DRAWN && sample.received < frameEnd)
+		{
+			sample.drawn = time;
+			sample.stages = LATENCY_DRAWN + 1;
+			m_Latencies[sample.kind][LATENCY_DRAWN].push_back(getMicroseconds(time - sample.received));
+		}
+	}
+}
+
+/// @brief display returned, the frame holding every drawn sample is on its way to the screen
+void LatencyProbe::presented(Clock::time_point time)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	std::size_t kept = 0;
+
+	for (Sample& sample : m_Pending)
+	{
+		if (sample.stages == LATENCY_PRESENTED)
+		{
+			m_Latencies[sample.kind][LATENCY_PRESENTED].push_back(getMicroseconds(time - sample.received));
+		}
+		else
+		{
+			m_Pending[kept++] = sample;
+		}
+	}
+
+	m_Pending.resize(kept);
+}
+
+/// @brief Presses of the kind followed all the way to display
+std::size_t LatencyProbe::getSampleCount(unsigned char kind) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	return m_Latencies[kind][LATENCY_PRESENTED].size();
+}
+
+/// @brief Nearest rank percentile of the time to a stage in microseconds, 0 without samples
+unsigned int LatencyProbe::getPercentile(unsigned char kind, LatencyStage stage, double percentile) const
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	std::vector<unsigned int> latencies = m_Latencies[kind][stage];
+	lock.unlock();
+
+	if (latencies.empty())
+	{
+		return 0;
+	}
+
+	std::size_t rank = std::min<std::size_t>(std::ceil(percentile / 100 * latencies.size()), latencies.size());
+	std::size_t index = rank > 0 ? rank - 1 : 0;
+	std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+
+	return latencies[index];
+}
+
+/// @brief Writes the distribution of each stage per input kind, in milliseconds
+void LatencyProbe::report(std::ostream& out) const
+{
+	const char* kindNames[LATENCY_KINDS] = { "left", "right", "soft drop", "rotate ccw", "rotate cw", "hold", "hard drop", "start" };
+	const char* stageNames[LATENCY_STAGES] = { "logic", "draw", "display" };
+	const double percentiles[] = { 0, 50, 95, 99, 100 };
+
+	out << std::fixed << std::setprecision(2) << "input      stage     count     min     p50     p95     p99     max (ms)\n";
+
+	for (unsigned char kind = 0; kind < LATENCY_KINDS; kind++)
+	{
+		for (unsigned char stage = 0; stage < LATENCY_STAGES; stage++)
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			std::size_t count = m_Latencies[kind][stage].size();
+			lock.unlock();
+
+			if (count == 0)
+			{
+				continue;
+			}
+
+			out << std::left << std::setw(11) << kindNames[kind] << std::setw(8) << stageNames[stage] << std::right << std::setw(7) << count;
+
+			for (double percentile : percentiles)
+			{
+				out << std::setw(8) << getPercentile(kind, static_cast<LatencyStage>(stage), percentile) / 1000.0;
+			}
+
+			out << '\n';
+		}
+	}
+}
+
+SyntheticInput::SyntheticInput(Clock::time_point start, Clock::duration period) :
+	m_Next(start),
+	m_Period(period)
+{
+}
+
+/// @brief Returns the next injected press or release once it is due
+bool SyntheticInput::poll(Clock::time_point now, unsigned char& bits, bool& pressed)
+{
+	if (now < m_Next)
+	{
+		return false;
+	}
+
+	bits = 1 << m_Kind;
+	pressed = !m_Pressed;
+	m_Pressed = pressed;
+
+	if (pressed)
+	{
+		m_Next += m_Period / 2;
+	}
+	else
+	{
+		m_Next += m_Period - m_Period / 2;
+		m_Kind = (m_Kind + 1) % LATENCY_KINDS;
+	}
+
+	return true;
+}
@@ -1,13 +1,331 @@
 #include <iostream>
 #include <random>
-#include <set>
 
+#include "Headers/GameEvents.hpp"
+#include "Headers/GameSession.hpp"
+#include "Headers/AssetArchive.hpp"
+#include "Headers/AudioEngine.hpp"
+#include "Headers/FramePacer.hpp"
 #include "Headers/Global.hpp"
+#include "Headers/Hash.hpp"
+#include "Headers/InputQueue.hpp"
+#include "Headers/LatencyProbe.hpp"
+#include "Headers/Netplay.hpp"
+#include "Headers/Replay.hpp"
+#include "Headers/Rollback.hpp"
+#include "Headers/SfmlAudioOutput.hpp"
+#include "Headers/StartupTimeline.hpp"
 #include "Headers/Tetromino.hpp"
+#include "Headers/TripleBuffer.hpp"
 #include "Platform/Platform.hpp"
 
-int main()
+namespace
 {
+// How often the start and game over screens look for input, slower when the window is in the background
+constexpr std::chrono::milliseconds IDLE_POLL_INTERVAL(50);
+constexpr std::chrono::milliseconds UNFOCUSED_POLL_INTERVAL(250);
+
+/// @brief Maps a keyboard key to its bit in the per-frame input mask
+unsigned char getInputBit(sf::Keyboard::Key key)
+{
+	switch (key)
+	{
+		case sf::Keyboard::Left: return INPUT_LEFT;
+		case sf::Keyboard::Right: return INPUT_RIGHT;
+		case sf::Keyboard::Down: return INPUT_DOWN;
+		case sf::Keyboard::Z: return INPUT_ROTATE_CCW;
+		case sf::Keyboard::X: return INPUT_ROTATE_CW;
+		case sf::Keyboard::C: return INPUT_HOLD;
+		case sf::Keyboard::Space: return INPUT_HARD_DROP;
+		case sf::Keyboard::Enter: return INPUT_START;
+		default: return 0;
+	}
+}
+
+/// @brief Parses a command line number clamped to [low, high], throwing std::invalid_argument if it isn't one
+int parseClamped(const std::string& text, int low, int high)
+{
+	try
+	{
+		return std::clamp(std::stoi(text), low, high);
+	}
+	catch (const std::out_of_range&)
+	{
+		return text[0] == '-' ? low : high;
+	}
+}
+
+/// @brief Everything the render thread needs to draw one logic frame
+struct FrameSnapshot
+{
+	std::array<GameSession, 2> boards;
+	unsigned char boardCount = 1;
+	// End of the logic frame, for following presses through the latency probe
+	std::chrono::steady_clock::time_point frameEnd;
+};
+
+/// @brief Mixes everything drawSession shows into the hash, so frames that would look the same aren't drawn again
+unsigned long long hashVisibleState(unsigned long long hash, const GameSession& session)
+{
+	hash = hashBytes(hash, &session.matrix, sizeof(session.matrix));
+	hash = session.tetromino.hash(hash);
+	hash = hashWord(hash, (static_cast<unsigned long long>(static_cast<unsigned int>(session.score)) << 32) | session.clearedLines);
+	hash = hashWord(hash, session.currentGameState | (session.clearLineTimer << 8) | (session.level << 16));
+
+	return finalizeHash(hash);
+}
+
+/// @brief Draws one board with its next, hold and score panel into the current view
+void drawSession(sf::RenderWindow& window, const sf::Font& font, const std::vector<sf::Color>& cellColors, GameSession& session)
+{
+	Matrix& matrix = session.matrix;
+	Tetromino& tetromino = session.tetromino;
+
+	sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
+	float centerOffset = (CELL_SIZE - 1) / 2;
+	cell.setOrigin(centerOffset, centerOffset);
+
+	sf::Text previewText;
+	previewText.setFont(font);
+	previewText.setString("NEXT");
+	sf::FloatRect textRect = previewText.getLocalBounds();
+	previewText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
+	previewText.setScale(sf::Vector2f(0.25, 0.25));
+	previewText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 1));
+	window.draw(previewText);
+
+	sf::RectangleShape previewBorder(sf::Vector2f(5 * CELL_SIZE, 5 * CELL_SIZE));
+	previewBorder.setFillColor(sf::Color(0, 0, 0));
+	sf::FloatRect previewRect = previewBorder.getLocalBounds();
+	previewBorder.setOrigin(previewRect.left + previewRect.width / 2.0f, previewRect.top + previewRect.height / 2.0f);
+	previewBorder.setOutlineThickness(-1);
+	previewBorder.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 4.5));
+	window.draw(previewBorder);
+
+	previewText.setString("HOLD");
+	previewText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 8));
+	previewBorder.setPosition((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 11.5);
+	window.draw(previewBorder);
+	window.draw(previewText);
+
+	sf::Text scoreText;
+	scoreText.setFont(font);
+	scoreText.setString(std::string("Score: ") + std::to_string(session.score) + std::string("\nLevel: ") + std::to_string(session.level));
+	sf::FloatRect scoreTextRect = scoreText.getLocalBounds();
+	scoreText.setOrigin(scoreTextRect.left + scoreTextRect.width / 2.0f, scoreTextRect.top + scoreTextRect.height / 2.0f);
+	scoreText.setScale(sf::Vector2f(0.25, 0.25));
+	scoreText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 16));
+	window.draw(scoreText);
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		// The hidden rows aren't drawn
+		for (unsigned char y = BUFFER_ROWS; y < ROWS; y++)
+		{
+			cell.setPosition((CELL_SIZE * x) + centerOffset, (CELL_SIZE * (y - BUFFER_ROWS)) + centerOffset);
+
+			// Draw cells grayed out when in the game over state
+			if (session.currentGameState == GameState::GAME_OVER && matrix[x][y] > 0)
+			{
+				cell.setFillColor(cellColors[8]);
+			}
+			else
+			{
+				cell.setScale(1, 1);
+				cell.setFillColor(cellColors[matrix[x][y]]);
+
+				if ((session.clearedLines >> y) & 1)
+				{
+					cell.setScale(((float)session.clearLineTimer) / 30 + 0.2, ((float)session.clearLineTimer) / 30 + 0.2);
+				}
+			}
+
+			window.draw(cell);
+		}
+	}
+
+	cell.setScale(1, 1);
+
+	// Render tetromino while gameplay is active
+	if (session.currentGameState == GameState::IN_PROGRESS)
+	{
+		cell.setFillColor(cellColors[8]);
+
+		if (session.clearLineTimer == 0)
+		{
+			for (Vector2i mino : tetromino.getGhostMinos(matrix))
+			{
+				cell.setPosition((CELL_SIZE * mino.x) + centerOffset, (CELL_SIZE * (mino.y - BUFFER_ROWS)) + centerOffset);
+				window.draw(cell);
+			}
+
+			cell.setFillColor(cellColors[1 + tetromino.getShape()]);
+
+			for (Vector2i mino : tetromino.getMinos())
+			{
+				cell.setPosition((CELL_SIZE * mino.x) + centerOffset, (CELL_SIZE * (mino.y - BUFFER_ROWS)) + centerOffset);
+
+				window.draw(cell);
+			}
+		}
+
+		for (Vector2i mino : tetromino.getNextShapeTetromino(1.5f * COLUMNS, 0.25f * VISIBLE_ROWS))
+		{
+			//Shifting the tetromino to the center of the preview border
+			unsigned short nextTetrominoX = (CELL_SIZE * mino.x) + centerOffset;
+			unsigned short nextTetrominoY = (CELL_SIZE * mino.y) + centerOffset;
+
+			if (tetromino.getNextShape() == Tetromino::Shape::I)
+			{
+				nextTetrominoY += round(0.5f * CELL_SIZE);
+			}
+			else if (tetromino.getNextShape() != Tetromino::Shape::O)
+			{
+				nextTetrominoX -= round(0.5f * CELL_SIZE);
+			}
+
+			cell.setFillColor(cellColors[1 + tetromino.getNextShape()]);
+			cell.setPosition(nextTetrominoX, nextTetrominoY);
+			window.draw(cell);
+		}
+
+		if (tetromino.isHolding())
+		{
+			for (Vector2i mino : tetromino.getHoldMinos(1.5f * COLUMNS, 0.64f * VISIBLE_ROWS))
+			{
+				//Shifting the tetromino to the center of the preview border
+				unsigned short nextTetrominoX = CELL_SIZE * mino.x + centerOffset;
+				unsigned short nextTetrominoY = CELL_SIZE * mino.y + centerOffset;
+
+				if (tetromino.getHoldingShape() == Tetromino::Shape::I)
+				{
+					nextTetrominoY += round(0.5f * CELL_SIZE);
+				}
+				else if (tetromino.getHoldingShape() != Tetromino::Shape::O)
+				{
+					nextTetrominoX -= round(0.5f * CELL_SIZE);
+				}
+
+				cell.setFillColor(cellColors[1 + tetromino.getHoldingShape()]);
+				cell.setPosition(nextTetrominoX, nextTetrominoY);
+				window.draw(cell);
+			}
+		}
+	}
+
+	if (session.currentGameState == GameState::GAME_OVER || session.currentGameState == GameState::NOT_STARTED)
+	{
+		sf::Text startText;
+		startText.setFont(font);
+		startText.setString("Press ENTER to start");
+		sf::FloatRect textRect = startText.getLocalBounds();
+		startText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
+		startText.setScale(sf::Vector2f(0.20, 0.20));
+		startText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * (VISIBLE_ROWS - 1.5f)));
+		window.draw(startText);
+	}
+}
+}
+
+/// @brief Usage:
+///   Tetris [--record <file> | --replay <file>] [--handling <das ms> <arr ms> <soft drop factor>] [--latency [self test seconds]]
+///          [--pacing <slack ms>] [--startup]
+///   Tetris --netplay <local port> <remote host> <remote port> <player 0|1> <seed>
+///   Tetris --relay <port A> <port B> <delay ms> [jitter ms] [loss %]
+///   Tetris --pack <content directory> <archive>
+int main(int argc, char* argv[])
+{
+	StartupTimeline timeline(std::chrono::steady_clock::now());
+	std::vector<std::string> args(argv + 1, argv + argc);
+	Handling handling;
+
+	for (std::size_t i = 0; i + 3 < args.size(); i++)
+	{
+		if (args[i] == "--handling")
+		{
+			try
+			{
+				handling.das = getHandlingTime(parseClamped(args[i + 1], 0, MAX_HANDLING_MILLISECONDS));
+				handling.arr = getHandlingTime(parseClamped(args[i + 2], 0, MAX_HANDLING_MILLISECONDS));
+				handling.softDropFactor = parseClamped(args[i + 3], 1, 0xFF);
+			}
+			catch (const std::invalid_argument&)
+			{
+				std::cerr << "--handling takes <das ms> <arr ms> <soft drop factor> as numbers" << std::endl;
+				return 1;
+			}
+
+			args.erase(args.begin() + i, args.begin() + i + 4);
+			break;
+		}
+	}
+
+	// Frame pacing, the spin before each frame and whether to report the pacer's numbers on exit
+	bool isPacingReported = false;
+	FramePacer pacer;
+
+	for (std::size_t i = 0; i + 1 < args.size(); i++)
+	{
+		if (args[i] == "--pacing")
+		{
+			isPacingReported = true;
+			pacer = FramePacer(std::chrono::microseconds(static_cast<long long>(std::stod(args[i + 1]) * 1000)));
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			break;
+		}
+	}
+
+	// Measures the time from launch to the first frame on screen, prints each stage on the way and quits
+	bool isStartupReported = std::find(args.begin(), args.end(), "--startup") != args.end();
+	args.erase(std::remove(args.begin(), args.end(), "--startup"), args.end());
+
+	// Latency diagnostics, optionally driven by injected key presses for a number of seconds
+	bool isMeasuring = false;
+	int selfTestSeconds = 0;
+
+	for (std::size_t i = 0; i < args.size(); i++)
+	{
+		if (args[i] == "--latency")
+		{
+			isMeasuring = true;
+			std::size_t end = i + 1;
+
+			if (end < args.size() && std::isdigit(static_cast<unsigned char>(args[end][0])))
+			{
+				selfTestSeconds = std::stoi(args[end++]);
+			}
+
+			args.erase(args.begin() + i, args.begin() + end);
+			break;
+		}
+	}
+
+	if (args.size() >= 3 && args[0] == "--pack")
+	{
+		return AssetArchive::pack(args[1], args[2]) ? 0 : 1;
+	}
+
+	if (args.size() >= 4 && args[0] == "--relay")
+	{
+		LatencyRelay relay(std::stoi(args[1]), std::stoi(args[2]), std::stoi(args[3]), args.size() > 4 ? std::stoi(args[4]) : 0, args.size() > 5 ? std::stoi(args[5]) : 0);
+
+		if (!relay.start())
+		{
+			return 1;
+		}
+
+		std::cout << "Relaying " << args[1] << " <-> " << args[2] << " with " << args[3] << " ms delay" << std::endl;
+
+		while (true)
+		{
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+		}
+	}
+
+	bool isNetplay = args.size() >= 6 && args[0] == "--netplay";
+	bool isRecording = args.size() >= 2 && args[0] == "--record";
+	bool isReplaying = args.size() >= 2 && args[0] == "--replay";
+
 	// Cell colors for each shape and the background
 	std::vector<sf::Color> cellColors = {
 		sf::Color(36, 36, 85),
@@ -21,442 +339,401 @@ int main()
 		sf::Color(73, 73, 85)
 	};
 
+	// Production builds pack content/ into one archive, development runs read the loose files
+	AssetArchive assets;
+	assets.open(ASSET_ARCHIVE_PATH);
+	timeline.mark("assets");
+
 	sf::Font font;
-	font.loadFromFile("content/arial.ttf");
+	AssetSpan fontAsset;
 
-	// Timing Setup
-	unsigned frameTimer = 0;
-	std::chrono::time_point<std::chrono::steady_clock> previous_time;
-	previous_time = std::chrono::steady_clock::now();
+	if (assets.find("arial.ttf", fontAsset) ? !font.loadFromMemory(fontAsset.data, fontAsset.size) : !font.loadFromFile("content/arial.ttf"))
+	{
+		std::cerr << "Could not load the font arial.ttf from " << ASSET_ARCHIVE_PATH << " or content/" << std::endl;
+		return 1;
+	}
+
+	timeline.mark("font");
 
 	// Game Variables
-	std::vector<std::vector<unsigned char>> matrix(COLUMNS, std::vector<unsigned char>(ROWS));
-	std::set<unsigned char> clearedLines;
-	unsigned char clearLineTimer = 0;
-	Tetromino tetromino;
-	GameState currentGameState = GameState::NOT_STARTED;
-	unsigned char fallTimer;
-	unsigned char currentFallSpeed = START_FALL_SPEED;
-	int score = 0;
-	unsigned char level = 1;
-	int totalLinesCleared = 0;
-	bool hasHeld;
+	Replay replay(std::chrono::system_clock::now().time_since_epoch().count());
+
+	if (isReplaying && !replay.load(args[1]))
+	{
+		std::cerr << "Could not load replay " << args[1] << std::endl;
+		return 1;
+	}
+
+	if (!isReplaying)
+	{
+		replay.setHandling(handling);
+	}
+
+	// Netplay sessions keep the default handling, the peer has no way to know ours
+	GameSession session(replay.getSeed());
+	session.handling = replay.getHandling();
+
+	// Consumers subscribe before the first frame and drain their queues on their own threads
+	GameEventBus gameEvents;
+	session.events = &gameEvents;
+
+	SfmlAudioOutput audioOutput(assets);
+	AudioEngine audio(audioOutput, *gameEvents.subscribe());
+
+	int frame = 0;
+
+	// Netplay Variables
+	std::unique_ptr<RollbackSession> rollback;
+	std::unique_ptr<NetplayPeer> peer;
+	int waitFrames = 0;
+
+	if (isNetplay)
+	{
+		rollback = std::make_unique<RollbackSession>(std::stoi(args[4]), std::stoull(args[5]));
+		peer = std::make_unique<NetplayPeer>(*rollback);
+
+		if (!peer->connect(std::stoi(args[1]), sf::IpAddress(args[2]), std::stoi(args[3])))
+		{
+			return 1;
+		}
+	}
+
+	// Nothing sounds before the first frame, so the sounds are decoded on their own thread while the window comes up.
+	// Events published in the meantime wait in the audio queue
+	std::thread audioStarter([&]()
+	{
+		if (!audio.start())
+		{
+			std::cerr << "Could not start audio" << std::endl;
+		}
+
+		timeline.mark("audio");
+	});
+
+	unsigned char boardCount = isNetplay ? 2 : 1;
 
 	// Input Variables
-	float fallSpeedMultiplier = 1;
-	bool hardDropPressed;
-	bool hardDropProcessed = true;
-	bool rotatePressed;
-	signed char moveTimer = 0;
+	InputQueue inputQueue;
+	// Netplay input gathered while waiting to advance
+	unsigned char pendingInput = 0;
+
+	// X has to know before the first call that the render thread will draw while this one polls events
+	util::Platform platform;
+	timeline.mark("platform");
 
 	// Window Setup
-	sf::RenderWindow window(sf::VideoMode((CELL_SIZE * COLUMNS * SCREEN_RESIZE) + (INFO_VIEW * SCREEN_RESIZE), CELL_SIZE * ROWS * SCREEN_RESIZE), "Tetris");
-	window.setView(sf::View(sf::FloatRect(0, 0, CELL_SIZE * COLUMNS + INFO_VIEW, CELL_SIZE * ROWS)));
-	// in Windows at least, this must be called before creating the window
-	// Use the screenScalingFactor
-	window.setFramerateLimit(60);
+	sf::RenderWindow window(sf::VideoMode(boardCount * ((CELL_SIZE * COLUMNS * SCREEN_RESIZE) + (INFO_VIEW * SCREEN_RESIZE)), CELL_SIZE * VISIBLE_ROWS * SCREEN_RESIZE), "Tetris");
+	window.setKeyRepeatEnabled(false);
+	timeline.mark("window");
 
-	sf::Event event;
-	while (window.isOpen())
+	// Timing Setup
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	// The first frame runs at once so the start screen isn't a frame late
+	std::chrono::steady_clock::time_point nextFrameTime = startTime;
+
+	LatencyProbe latency;
+	SyntheticInput syntheticInput(startTime, std::chrono::milliseconds(97));
+
+	// Rendering
+	unsigned long long drawnHash = 0;
+	bool isRedrawNeeded = true;
+	bool hasFocus = true;
+	// The render thread ends a startup measurement once the first frame is on screen
+	std::atomic<bool> isRunning { true };
+
+	auto getBoardSession = [&](unsigned char board) -> GameSession&
 	{
-		unsigned delta_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - previous_time).count();
-		previous_time += std::chrono::microseconds(delta_time);
-		frameTimer += delta_time;
+		// Local player always on the left
+		return isNetplay ? rollback->getPlayer(board == 0 ? rollback->getLocalPlayer() : 1 - rollback->getLocalPlayer()) : session;
+	};
 
-		// Parse each frame
-		while (frameTimer >= FRAME_DURATION)
+	// The render thread owns the GL context and draws the latest published frame, so a blocking display or a slow
+	// draw never holds up input or gravity. The lock only guards its sleep, frames go through the triple buffer
+	TripleBuffer<FrameSnapshot> frames;
+	std::mutex renderMutex;
+	std::condition_variable renderCondition;
+	std::atomic<bool> isRendering { true };
+
+	window.setActive(false);
+
+	std::thread renderThread([&]()
+	{
+		window.setActive(true);
+		window.setVerticalSyncEnabled(true);
+
+		while (isRendering.load(std::memory_order_acquire))
 		{
-			frameTimer -= FRAME_DURATION;
+			bool isFresh = false;
 
-			while (window.pollEvent(event))
 			{
-				switch (event.type)
+				// Checked under the lock so a frame published between the check and the wait still wakes it
+				std::unique_lock<std::mutex> lock(renderMutex);
+				renderCondition.wait(lock, [&]()
 				{
-					case sf::Event::Closed: {
-						window.close();
-						break;
-					}
-					case sf::Event::KeyPressed: {
-						switch (event.key.code)
-						{
-							case sf::Keyboard::Z: {
-								if (!rotatePressed)
-								{
-									rotatePressed = true;
-									tetromino.rotate(false, matrix);
-								}
-								break;
-							}
-							case sf::Keyboard::X: {
-								if (!rotatePressed)
-								{
-									rotatePressed = true;
-									tetromino.rotate(true, matrix);
-								}
-
-								break;
-							}
-							case sf::Keyboard::C: {
-								if (!hasHeld)
-								{
-									hasHeld = true;
-									tetromino.processHoldSwap(matrix);
-								}
-								break;
-							}
-							case sf::Keyboard::Space: {
-								if (!hardDropPressed)
-								{
-									hardDropPressed = true;
-									hardDropProcessed = false;
-									score += tetromino.hardDrop(matrix) * 2;
-								}
-								break;
-							}
-							default:
-								break;
-						}
-						break;
-					}
-					case sf::Event::KeyReleased: {
-						switch (event.key.code)
-						{
-							case sf::Keyboard::X:
-							case sf::Keyboard::Z: {
-								rotatePressed = false;
-
-								break;
-							}
-							case sf::Keyboard::Space: {
-								hardDropPressed = false;
-								break;
-							}
-							default:
-								break;
-						}
-						break;
-					}
-					default:
-						break;
-				}
+					isFresh = frames.update();
+					return isFresh || !isRendering.load(std::memory_order_acquire);
+				});
 			}
 
-			if (currentGameState == GameState::GAME_OVER)
+			if (!isFresh)
 			{
-				if (sf::Keyboard::isKeyPressed(sf::Keyboard::Enter))
-				{
-					moveTimer = 0;
-					fallTimer = 0;
-					fallSpeedMultiplier = 1;
-					currentFallSpeed = START_FALL_SPEED;
-					rotatePressed = false;
+				continue;
+			}
 
-					for (std::vector<unsigned char>& a : matrix)
-					{
-						std::fill(a.begin(), a.end(), 0);
-					}
+			FrameSnapshot& snapshot = frames.getFront();
+			window.clear();
 
-					currentGameState = GameState::IN_PROGRESS;
-				}
+			for (unsigned char board = 0; board < snapshot.boardCount; board++)
+			{
+				sf::View view(sf::FloatRect(0, 0, CELL_SIZE * COLUMNS + INFO_VIEW, CELL_SIZE * VISIBLE_ROWS));
+				view.setViewport(sf::FloatRect(static_cast<float>(board) / snapshot.boardCount, 0, 1.0f / snapshot.boardCount, 1));
+				window.setView(view);
+
+				drawSession(window, font, cellColors, snapshot.boards[board]);
 			}
-			else if (currentGameState == GameState::IN_PROGRESS)
+
+			if (isMeasuring)
 			{
-				if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) && moveTimer >= 0)
-				{
-					moveTimer = -4;
-					tetromino.moveLeft(matrix);
-				}
-				else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) && moveTimer <= 0)
-				{
-					moveTimer = 4;
-					tetromino.moveRight(matrix);
-				}
+				latency.drawn(snapshot.frameEnd, std::chrono::steady_clock::now());
+			}
 
-				if (moveTimer < 0)
-					moveTimer++;
-				else if (moveTimer > 0)
-					moveTimer--;
+			if (isStartupReported && timeline.getElapsed("first-draw") < 0)
+			{
+				timeline.mark("first-draw");
+			}
 
-				if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down))
-				{
-					fallSpeedMultiplier = 0.25;
+			window.display();
+
+			if (isMeasuring)
+			{
+				latency.presented(std::chrono::steady_clock::now());
+			}
+
+			if (isStartupReported && timeline.getElapsed("first-present") < 0)
+			{
+				timeline.mark("first-present");
+				isRunning = false;
+			}
+		}
+
+		window.setActive(false);
+	});
+
+	sf::Event event;
+	while (isRunning)
+	{
+		bool isIdle = !isNetplay && !isReplaying && selfTestSeconds == 0 && !isRedrawNeeded &&
+			(session.currentGameState == GameState::NOT_STARTED || session.currentGameState == GameState::GAME_OVER);
+
+		if (isIdle)
+		{
+			// Nothing moves until a key is pressed. SFML 2's waitEvent can't time out, so sleep in slices and poll between them
+			std::this_thread::sleep_for(hasFocus ? IDLE_POLL_INTERVAL : UNFOCUSED_POLL_INTERVAL);
+			nextFrameTime = std::max(nextFrameTime, std::chrono::steady_clock::now());
+		}
+		else
+		{
+			// Sleep until just before the frame is due, then spin here polling input until it is
+			pacer.sleep(nextFrameTime);
+		}
+
+		// Events are stamped as soon as they are polled so each lands in the frame it happened in,
+		// however late the fixed step loop below runs
+		while (window.pollEvent(event))
+		{
+			switch (event.type)
+			{
+				case sf::Event::Closed: {
+					isRunning = false;
+					break;
 				}
-				else
-				{
-					fallSpeedMultiplier = 1;
+				case sf::Event::LostFocus: {
+					hasFocus = false;
+					inputQueue.clear();
+					break;
 				}
-
-				if (clearLineTimer > 0)
-				{
-					if (--clearLineTimer == 0)
-					{
-						for (unsigned char clearedLine : clearedLines)
-						{
-							for (unsigned char x = 0; x < COLUMNS; x++)
-							{
-								matrix[x][clearedLine] = 0;
-
-								for (unsigned char i = clearedLine; i > 0; i--)
-								{
-									matrix[x][i] = matrix[x][i - 1];
-									matrix[x][i - 1] = 0;
-								}
-							}
-						}
-
-						if (clearedLines.size() == 1)
-						{
-							score += 100 * level;
-						}
-						else if (clearedLines.size() == 2)
-						{
-							score += 300 * level;
-						}
-						else if (clearedLines.size() == 3)
-						{
-							score += 500 * level;
-						}
-						else if (clearedLines.size() == 4)
-						{
-							score += 800 * level;
-						}
-
-						totalLinesCleared += clearedLines.size();
-						level = std::max((totalLinesCleared / 10.0) + 1, 1.0);
-						clearedLines.clear();
-						hasHeld = false;
-
-						if (!tetromino.reset(matrix))
-						{
-							currentGameState = GameState::GAME_OVER;
-						}
-					}
+				case sf::Event::GainedFocus: {
+					hasFocus = true;
+					isRedrawNeeded = true;
+					break;
 				}
-				// Auto move piece down or force an update if a hard drop was sent
-				else if (fallTimer >= (currentFallSpeed * fallSpeedMultiplier) || !hardDropProcessed)
-				{
-					if (fallSpeedMultiplier != 1)
-					{
-						score += 1;
-					}
+				case sf::Event::Resized: {
+					isRedrawNeeded = true;
+					break;
+				}
+				case sf::Event::KeyPressed: {
+					std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+					inputQueue.push(getInputBit(event.key.code), true, now);
 
-					if (!tetromino.moveDown(matrix))
+					if (isMeasuring)
 					{
-						tetromino.updateMatrix(matrix);
-
-						// Check if lines should be cleared
-						int lowY = ROWS;
-						int highY = 0;
-
-						for (sf::Vector2i mino : tetromino.getMinos())
-						{
-							if (mino.y < lowY)
-							{
-								lowY = mino.y;
-							}
-
-							if (mino.y > highY)
-							{
-								highY = mino.y;
-							}
-						}
-
-						for (int i = lowY; i <= highY; i++)
-						{
-							bool lineCleared = true;
-
-							for (int j = 0; j < COLUMNS; j++)
-							{
-								if (matrix[j][i] == 0)
-								{
-									lineCleared = false;
-									break;
-								}
-							}
-
-							if (lineCleared)
-							{
-								clearedLines.insert(i);
-								clearLineTimer = 30;
-							}
-						}
-
-						// If there wasn't a line cleared, setup the next shape.
-						if (clearLineTimer == 0)
-						{
-							if (!tetromino.reset(matrix))
-							{
-								currentGameState = GameState::GAME_OVER;
-							}
-
-							hasHeld = false;
-						}
+						latency.received(getInputBit(event.key.code), now);
 					}
 
-					fallTimer = 0;
-					hardDropProcessed = true;
+					break;
 				}
-				else
-				{
-					fallTimer++;
+				case sf::Event::KeyReleased: {
+					inputQueue.push(getInputBit(event.key.code), false, std::chrono::steady_clock::now());
+					break;
 				}
+				default:
+					break;
 			}
-			else if (currentGameState == GameState::NOT_STARTED)
+		}
+
+		if (selfTestSeconds > 0)
+		{
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			unsigned char bits;
+			bool pressed;
+
+			while (syntheticInput.poll(now, bits, pressed))
 			{
-				if (sf::Keyboard::isKeyPressed(sf::Keyboard::Enter))
+				inputQueue.push(bits, pressed, now);
+
+				if (pressed)
 				{
-					currentGameState = GameState::IN_PROGRESS;
+					latency.received(bits, now);
 				}
 			}
 
-			sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
-			float centerOffset = (CELL_SIZE - 1) / 2;
-			cell.setOrigin(centerOffset, centerOffset);
-
-			window.clear();
-
-			sf::Text previewText;
-			previewText.setFont(font);
-			previewText.setString("NEXT");
-			sf::FloatRect textRect = previewText.getLocalBounds();
-			previewText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
-			previewText.setScale(sf::Vector2f(0.25, 0.25));
-			previewText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 1));
-			window.draw(previewText);
-
-			sf::RectangleShape previewBorder(sf::Vector2f(5 * CELL_SIZE, 5 * CELL_SIZE));
-			previewBorder.setFillColor(sf::Color(0, 0, 0));
-			sf::FloatRect previewRect = previewBorder.getLocalBounds();
-			previewBorder.setOrigin(previewRect.left + previewRect.width / 2.0f, previewRect.top + previewRect.height / 2.0f);
-			previewBorder.setOutlineThickness(-1);
-			previewBorder.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 4.5));
-			window.draw(previewBorder);
-
-			previewText.setString("HOLD");
-			previewText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 8));
-			previewBorder.setPosition((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 11.5);
-			window.draw(previewBorder);
-			window.draw(previewText);
-
-			sf::Text scoreText;
-			scoreText.setFont(font);
-			scoreText.setString(std::string("Score: ") + std::to_string(score) + std::string("\nLevel: ") + std::to_string(level));
-			sf::FloatRect scoreTextRect = scoreText.getLocalBounds();
-			scoreText.setOrigin(scoreTextRect.left + scoreTextRect.width / 2.0f, scoreTextRect.top + scoreTextRect.height / 2.0f);
-			scoreText.setScale(sf::Vector2f(0.25, 0.25));
-			scoreText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * 16));
-			window.draw(scoreText);
-
-			for (unsigned char x = 0; x < COLUMNS; x++)
+			if (now - startTime >= std::chrono::seconds(selfTestSeconds))
 			{
-				for (unsigned char y = 0; y < ROWS; y++)
-				{
-					cell.setPosition((CELL_SIZE * x) + centerOffset, (CELL_SIZE * y) + centerOffset);
-
-					// Draw cells grayed out when in the game over state
-					if (currentGameState == GameState::GAME_OVER && matrix[x][y] > 0)
-					{
-						cell.setFillColor(cellColors[8]);
-					}
-					else
-					{
-						cell.setScale(1, 1);
-						cell.setFillColor(cellColors[matrix[x][y]]);
+				isRunning = false;
+			}
+		}
 
-						if (clearedLines.count(y) == 1)
-						{
-							cell.setScale(((float)clearLineTimer) / 30 + 0.2, ((float)clearLineTimer) / 30 + 0.2);
-						}
-					}
+		// Parse each frame
+		while (std::chrono::steady_clock::now() >= nextFrameTime)
+		{
+			pacer.tick(nextFrameTime, std::chrono::steady_clock::now());
+			unsigned char input = inputQueue.popFrame(nextFrameTime);
 
-					window.draw(cell);
-				}
+			if (isMeasuring)
+			{
+				latency.consumed(nextFrameTime, std::chrono::steady_clock::now());
 			}
 
-			cell.setScale(1, 1);
+			std::chrono::steady_clock::time_point frameEnd = nextFrameTime;
+			nextFrameTime += std::chrono::microseconds(FRAME_DURATION);
 
-			// Render tetromino while gameplay is active
-			if (currentGameState == GameState::IN_PROGRESS)
+			if (isNetplay)
 			{
-				cell.setFillColor(cellColors[8]);
+				pendingInput |= input;
+				peer->receive();
 
-				if (clearLineTimer == 0)
+				if (waitFrames > 0)
 				{
-					for (sf::Vector2i mino : tetromino.getGhostMinos(matrix))
-					{
-						cell.setPosition((CELL_SIZE * mino.x) + centerOffset, (CELL_SIZE * mino.y) + centerOffset);
-						window.draw(cell);
-					}
-
-					cell.setFillColor(cellColors[1 + tetromino.getShape()]);
+					// Idle so the peer that is behind can catch up
+					waitFrames--;
+				}
+				else if (rollback->canAdvance())
+				{
+					rollback->advanceFrame(pendingInput);
+					pendingInput = 0;
 
-					for (sf::Vector2i mino : tetromino.getMinos())
+					if (rollback->getCurrentFrame() % TIME_SYNC_WINDOW == 0)
 					{
-						cell.setPosition((CELL_SIZE * mino.x) + centerOffset, (CELL_SIZE * mino.y) + centerOffset);
-
-						window.draw(cell);
+						waitFrames = rollback->getRecommendedWaitFrames();
 					}
 				}
 
-				for (sf::Vector2i mino : tetromino.getNextShapeTetromino(1.5f * COLUMNS, 0.25f * ROWS))
+				peer->sendInputs();
+			}
+			else if (isReplaying)
+			{
+				if (frame < replay.getFrameCount())
 				{
-					//Shifting the tetromino to the center of the preview border
-					unsigned short nextTetrominoX = (CELL_SIZE * mino.x) + centerOffset;
-					unsigned short nextTetrominoY = (CELL_SIZE * mino.y) + centerOffset;
+					session.step(replay.getInput(frame));
 
-					if (tetromino.getNextShape() == Tetromino::Shape::I)
+					if (session.hash() != replay.getHash(frame))
 					{
-						nextTetrominoY += round(0.5f * CELL_SIZE);
+						// Stop the playback at the first divergent frame
+						std::cerr << "Replay diverged at frame " << frame << std::endl;
+						session.dump(std::cerr);
+						frame = replay.getFrameCount();
 					}
-					else if (tetromino.getNextShape() != Tetromino::Shape::O)
+					else
 					{
-						nextTetrominoX -= round(0.5f * CELL_SIZE);
+						frame++;
 					}
-
-					cell.setFillColor(cellColors[1 + tetromino.getNextShape()]);
-					cell.setPosition(nextTetrominoX, nextTetrominoY);
-					window.draw(cell);
 				}
+			}
+			else
+			{
+				session.step(input);
 
-				if (tetromino.isHolding())
+				if (isRecording)
 				{
-					for (sf::Vector2i mino : tetromino.getHoldMinos(1.5f * COLUMNS, 0.64f * ROWS))
-					{
-						//Shifting the tetromino to the center of the preview border
-						unsigned short nextTetrominoX = CELL_SIZE * mino.x + centerOffset;
-						unsigned short nextTetrominoY = CELL_SIZE * mino.y + centerOffset;
-
-						if (tetromino.getHoldingShape() == Tetromino::Shape::I)
-						{
-							nextTetrominoY += round(0.5f * CELL_SIZE);
-						}
-						else if (tetromino.getHoldingShape() != Tetromino::Shape::O)
-						{
-							nextTetrominoX -= round(0.5f * CELL_SIZE);
-						}
-
-						cell.setFillColor(cellColors[1 + tetromino.getHoldingShape()]);
-						cell.setPosition(nextTetrominoX, nextTetrominoY);
-						window.draw(cell);
-					}
+					replay.record(input, session.hash());
 				}
 			}
 
-			if (currentGameState == GameState::GAME_OVER || currentGameState == GameState::NOT_STARTED)
+			// Most frames on the start and game over screens look exactly like the last one
+			unsigned long long visibleHash = 0;
+
+			for (unsigned char board = 0; board < boardCount; board++)
 			{
-				sf::Text startText;
-				startText.setFont(font);
-				startText.setString("Press ENTER to start");
-				sf::FloatRect textRect = startText.getLocalBounds();
-				startText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
-				startText.setScale(sf::Vector2f(0.20, 0.20));
-				startText.setPosition(sf::Vector2f((CELL_SIZE * COLUMNS) + (INFO_VIEW / 2), CELL_SIZE * (ROWS - 1.5f)));
-				window.draw(startText);
+				visibleHash = hashVisibleState(visibleHash, getBoardSession(board));
 			}
 
-			window.display();
+			if (visibleHash == drawnHash && !isRedrawNeeded)
+			{
+				continue;
+			}
+
+			drawnHash = visibleHash;
+			isRedrawNeeded = false;
+
+			FrameSnapshot& snapshot = frames.getBack();
+			snapshot.boardCount = boardCount;
+			snapshot.frameEnd = frameEnd;
+
+			for (unsigned char board = 0; board < boardCount; board++)
+			{
+				snapshot.boards[board] = getBoardSession(board);
+			}
+
+			frames.publish();
+
+			{
+				std::lock_guard<std::mutex> lock(renderMutex);
+			}
+
+			renderCondition.notify_one();
 		}
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(renderMutex);
+		isRendering.store(false, std::memory_order_release);
+	}
+
+	renderCondition.notify_one();
+	renderThread.join();
+	window.close();
+	audioStarter.join();
+	audio.stop();
+
+	if (isStartupReported)
+	{
+		timeline.report(std::cout);
+	}
+
+	if (isMeasuring)
+	{
+		latency.report(std::cout);
+	}
+
+	if (isPacingReported)
+	{
+		pacer.report(std::cout);
+	}
+
+	if (isRecording && !replay.save(args[1]))
+	{
+		std::cerr << "Could not save replay " << args[1] << std::endl;
+	}
+
 	return 0;
 }
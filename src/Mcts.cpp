@@ -0,0 +1,639 @@
+#include "Headers/Mcts.hpp"
+#include "Headers/Heuristic.hpp"
+
+namespace
+{
+// Returns are rewards / MCTS_REWARD_SCALE plus a leaf value in (0, 1), stored as fixed point
+constexpr float MCTS_REWARD_SCALE = 1000;
+constexpr float MCTS_VALUE_SCALE = 1 << 20;
+constexpr float MCTS_EXPLORATION = 0.35f;
+// The heuristic prior counts as this many visits of its own value
+constexpr float MCTS_PRIOR_VISITS = 1;
+constexpr unsigned int MCTS_ACTIONS_PER_DECISION = 24;
+
+}
+
+Mcts::Mcts(unsigned char threadCount, unsigned int nodeCapacity) :
+	m_Decisions(new DecisionNode[nodeCapacity]),
+	m_Actions(new ActionNode[nodeCapacity * MCTS_ACTIONS_PER_DECISION]),
+	m_DecisionCapacity(nodeCapacity),
+	m_ActionCapacity(nodeCapacity * MCTS_ACTIONS_PER_DECISION),
+	m_DecisionTop(0),
+	m_ActionTop(0),
+	m_Iterations(0)
+{
+	if (threadCount == 0)
+	{
+		threadCount = std::max(1u, std::min(255u, std::thread::hardware_concurrency()));
+	}
+
+	m_FreeDecisions.reserve(m_DecisionCapacity);
+	m_FreeActions.reserve(m_ActionCapacity);
+	m_DecisionMarks.resize(m_DecisionCapacity);
+	m_ActionMarks.resize(m_ActionCapacity);
+	collect();
+
+	for (unsigned char i = 0; i < threadCount; i++)
+	{
+		m_Workers.emplace_back(new Worker());
+		m_Workers.back()->random = 0x9E3779B97F4A7C15ULL * (i + 1);
+	}
+
+	// Worker 0 is whoever calls think
+	for (unsigned char i = 1; i < threadCount; i++)
+	{
+		m_Threads.emplace_back(&Mcts::runWorker, this, std::ref(*m_Workers[i]));
+	}
+}
+
+Mcts::~Mcts()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_Wake.notify_all();
+
+	for (std::thread& thread : m_Threads)
+	{
+		thread.join();
+	}
+}
+
+/// @brief Moves the root to the given state. Keeps the matching subtree when the state is an outcome of the last
+/// root's moves, which is the case after playing the best move. Returns whether a subtree was reused
+bool Mcts::setState(const SearchState& state)
+{
+	unsigned int root = MCTS_NONE;
+
+	if (m_Root != MCTS_NONE && m_Decisions[m_Root].expansion.load() == EXPANDED)
+	{
+		for (unsigned int action = m_Decisions[m_Root].firstAction; action != MCTS_NONE && root == MCTS_NONE; action = m_Actions[action].nextAction)
+		{
+			for (unsigned int outcome = m_Actions[action].firstOutcome; outcome != MCTS_NONE; outcome = m_Decisions[outcome].nextOutcome)
+			{
+				const SearchState& candidate = m_Decisions[outcome].state;
+
+				// The new state may know more of the queue than the tree did, refresh checks those against the draws
+				if (candidate.matrix == state.matrix && candidate.hold == state.hold && candidate.level == state.level &&
+					candidate.queueLength <= state.queueLength &&
+					std::equal(candidate.queue.begin(), candidate.queue.begin() + candidate.queueLength, state.queue.begin()))
+				{
+					root = outcome;
+					break;
+				}
+			}
+		}
+	}
+
+	m_Root = root;
+
+	if (root != MCTS_NONE)
+	{
+		refresh(root, state);
+		m_Decisions[root].nextOutcome = MCTS_NONE;
+		m_Decisions[root].drawCount = 0;
+	}
+
+	collect();
+
+	if (root == MCTS_NONE)
+	{
+		m_Root = allocateDecision(state);
+	}
+
+	return root != MCTS_NONE;
+}
+
+/// @brief Searches from the root until the budget runs out, always at least one iteration. Returns the iteration count
+unsigned int Mcts::think(std::chrono::microseconds budget)
+{
+	if (m_Root == MCTS_NONE)
+	{
+		return 0;
+	}
+
+	m_Iterations = 0;
+	m_Deadline = std::chrono::steady_clock::now() + budget;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Busy = m_Threads.size();
+		m_Generation++;
+	}
+
+	m_Wake.notify_all();
+	search(*m_Workers[0]);
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_Done.wait(lock, [this]() { return m_Busy == 0; });
+
+	return m_Iterations;
+}
+
+/// @brief Most visited move of the root, as a placement from MoveGenerator so it carries its rotation
+bool Mcts::getBestMove(Tetromino& placement, bool& useHold)
+{
+	if (m_Root == MCTS_NONE || m_Decisions[m_Root].expansion.load() != EXPANDED)
+	{
+		return false;
+	}
+
+	unsigned int best = MCTS_NONE;
+
+	for (unsigned int action = m_Decisions[m_Root].firstAction; action != MCTS_NONE; action = m_Actions[action].nextAction)
+	{
+		if (best == MCTS_NONE || m_Actions[action].visits > m_Actions[best].visits ||
+			(m_Actions[action].visits == m_Actions[best].visits && m_Actions[action].prior > m_Actions[best].prior))
+		{
+			best = action;
+		}
+	}
+
+	if (best == MCTS_NONE)
+	{
+		return false;
+	}
+
+	const SearchState& state = m_Decisions[m_Root].state;
+	Worker& worker = *m_Workers[0];
+	useHold = m_Actions[best].useHold;
+
+	if (!state.getPiece(useHold, worker.piece))
+	{
+		return false;
+	}
+
+	worker.generator.generate(state.matrix, worker.piece);
+	int index = worker.generator.find(Tetromino::getMinos(m_Actions[best].shape, m_Actions[best].position));
+
+	if (index < 0)
+	{
+		return false;
+	}
+
+	placement = worker.generator.getPlacement(index);
+	return true;
+}
+
+unsigned int Mcts::getRootVisits() const
+{
+	return m_Root == MCTS_NONE ? 0 : m_Decisions[m_Root].visits.load();
+}
+
+unsigned int Mcts::getFreeNodeCount() const
+{
+	return m_FreeDecisions.size() - std::min<unsigned int>(m_DecisionTop, m_FreeDecisions.size());
+}
+
+void Mcts::runWorker(Worker& worker)
+{
+	unsigned int generation = 0;
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_Wake.wait(lock, [&]() { return m_Quit || m_Generation != generation; });
+
+			if (m_Quit)
+			{
+				return;
+			}
+
+			generation = m_Generation;
+		}
+
+		search(worker);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		if (--m_Busy == 0)
+		{
+			m_Done.notify_one();
+		}
+	}
+}
+
+void Mcts::search(Worker& worker)
+{
+	do
+	{
+		iterate(worker);
+		m_Iterations++;
+	} while (std::chrono::steady_clock::now() < m_Deadline);
+}
+
+/// @brief One selection, expansion, rollout and backup pass. Actions on the path carry a virtual loss until backup
+/// so concurrent iterations spread over different branches
+void Mcts::iterate(Worker& worker)
+{
+	unsigned char depth = 0;
+	unsigned int decision = m_Root;
+	float value = 0;
+
+	while (true)
+	{
+		DecisionNode& node = m_Decisions[decision];
+		node.visits++;
+
+		unsigned char expansion = node.expansion.load(std::memory_order_acquire);
+
+		if (expansion == UNEXPANDED && node.expansion.compare_exchange_strong(expansion, EXPANDING, std::memory_order_acquire))
+		{
+			expand(worker, decision);
+			node.expansion.store(EXPANDED, std::memory_order_release);
+			expansion = EXPANDED;
+		}
+		else if (expansion != EXPANDED)
+		{
+			// Another thread is expanding it, evaluate from here rather than wait
+			value = rollout(worker, node.state);
+			break;
+		}
+
+		if (node.firstAction == MCTS_NONE)
+		{
+			// No piece can spawn, the game is lost
+			break;
+		}
+
+		if (depth == MCTS_MAX_DEPTH)
+		{
+			value = rollout(worker, node.state);
+			break;
+		}
+
+		unsigned int action = select(node);
+		ActionNode& chosen = m_Actions[action];
+		chosen.virtualLoss++;
+		worker.path[depth++] = action;
+
+		unsigned int next = getOutcome(worker, chosen, node.state);
+
+		if (next == MCTS_NONE)
+		{
+			// Out of nodes, finish this path with a rollout
+			SearchState state = node.state;
+			state.apply(Tetromino::getMinos(chosen.shape, chosen.position), chosen.shape, chosen.useHold);
+			drawMissing(state, worker.random);
+			value = rollout(worker, state);
+			break;
+		}
+
+		decision = next;
+
+		// Just expanded nodes are evaluated by a rollout before going deeper
+		if (m_Decisions[decision].expansion.load(std::memory_order_acquire) == UNEXPANDED)
+		{
+			m_Decisions[decision].visits++;
+			value = rollout(worker, m_Decisions[decision].state);
+			break;
+		}
+	}
+
+	while (depth > 0)
+	{
+		ActionNode& action = m_Actions[worker.path[--depth]];
+		value += action.reward / MCTS_REWARD_SCALE;
+
+		action.valueSum += static_cast<long long>(value * MCTS_VALUE_SCALE);
+		action.visits++;
+		action.virtualLoss--;
+	}
+}
+
+/// @brief Adds every placement of the current piece and of the hold piece as actions, with the board heuristic
+/// after the placement as prior
+void Mcts::expand(Worker& worker, unsigned int decision)
+{
+	DecisionNode& node = m_Decisions[decision];
+	const SearchState& state = node.state;
+
+	for (unsigned char hold = 0; hold < 2; hold++)
+	{
+		// Holding a piece of the same shape leads to the same placements
+		if (hold && state.hold == state.queue[0])
+		{
+			continue;
+		}
+
+		if (!state.getPiece(hold, worker.piece))
+		{
+			continue;
+		}
+
+		unsigned short placementCount = worker.generator.generate(state.matrix, worker.piece);
+
+		for (unsigned short i = 0; i < placementCount; i++)
+		{
+			unsigned int index = allocateAction();
+
+			if (index == MCTS_NONE)
+			{
+				return;
+			}
+
+			const Tetromino& placement = worker.generator.getPlacement(i);
+			ActionNode& action = m_Actions[index];
+			std::array<Vector2i, 4> minos = placement.getMinos();
+			action.position = placement.getPosition();
+
+			Matrix matrix = state.matrix;
+			unsigned char linesCleared = Heuristic::lock(matrix, minos, 1 + placement.getShape());
+
+			action.shape = placement.getShape();
+			action.useHold = hold;
+			action.reward = Heuristic::getLineClearScore(linesCleared, state.level);
+			action.prior = action.reward / MCTS_REWARD_SCALE + getLeafValue(Heuristic::evaluate(matrix, linesCleared));
+
+			action.nextAction = node.firstAction;
+			node.firstAction = index;
+		}
+	}
+}
+
+/// @brief UCT with the heuristic prior as an extra visit. In flight iterations count as visits that returned nothing
+unsigned int Mcts::select(DecisionNode& node)
+{
+	float logVisits = std::log(static_cast<float>(node.visits.load(std::memory_order_relaxed)) + 1);
+	unsigned int best = node.firstAction;
+	float bestScore = -1e30f;
+
+	for (unsigned int index = node.firstAction; index != MCTS_NONE; index = m_Actions[index].nextAction)
+	{
+		const ActionNode& action = m_Actions[index];
+		float visits = action.visits.load(std::memory_order_relaxed) + action.virtualLoss.load(std::memory_order_relaxed);
+		float value = action.valueSum.load(std::memory_order_relaxed) / MCTS_VALUE_SCALE + action.prior * MCTS_PRIOR_VISITS;
+		float score = value / (visits + MCTS_PRIOR_VISITS) + MCTS_EXPLORATION * std::sqrt(logVisits / (visits + 1));
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = index;
+		}
+	}
+
+	return best;
+}
+
+/// @brief Chance node: samples the bag draws the action needs and returns the decision node for them, adding it
+/// the first time those draws come up
+unsigned int Mcts::getOutcome(Worker& worker, ActionNode& action, const SearchState& parent)
+{
+	SearchState state = parent;
+	state.apply(Tetromino::getMinos(action.shape, action.position), action.shape, action.useHold);
+
+	std::array<Tetromino::Shape, 2> draws {};
+	unsigned char drawCount = 0;
+
+	while (state.queueLength < 2)
+	{
+		draws[drawCount++] = state.drawRandom(worker.random);
+	}
+
+	while (action.outcomeLock.test_and_set(std::memory_order_acquire))
+	{
+	}
+
+	unsigned int outcome = action.firstOutcome;
+
+	while (outcome != MCTS_NONE &&
+		(m_Decisions[outcome].drawCount != drawCount || !std::equal(draws.begin(), draws.begin() + drawCount, m_Decisions[outcome].draws.begin())))
+	{
+		outcome = m_Decisions[outcome].nextOutcome;
+	}
+
+	if (outcome == MCTS_NONE)
+	{
+		outcome = allocateDecision(state);
+
+		if (outcome != MCTS_NONE)
+		{
+			m_Decisions[outcome].draws = draws;
+			m_Decisions[outcome].drawCount = drawCount;
+			m_Decisions[outcome].nextOutcome = action.firstOutcome;
+			action.firstOutcome = outcome;
+		}
+	}
+
+	action.outcomeLock.clear(std::memory_order_release);
+	return outcome;
+}
+
+/// @brief Plays a few pieces greedily by the heuristic with random bag draws, then values the board
+float Mcts::rollout(Worker& worker, SearchState state)
+{
+	float value = 0;
+
+	for (unsigned char i = 0; i < MCTS_ROLLOUT_PIECES; i++)
+	{
+		if (!state.getPiece(false, worker.piece))
+		{
+			return value;
+		}
+
+		unsigned short placementCount = worker.generator.generate(state.matrix, worker.piece);
+		unsigned short best = 0;
+		float bestScore = -1e30f;
+
+		for (unsigned short p = 0; p < placementCount; p++)
+		{
+			Matrix matrix = state.matrix;
+			unsigned char linesCleared = Heuristic::lock(matrix, worker.generator.getPlacement(p).getMinos(), 1);
+			float score = Heuristic::evaluate(matrix, linesCleared);
+
+			if (score > bestScore)
+			{
+				bestScore = score;
+				best = p;
+			}
+		}
+
+		if (placementCount == 0)
+		{
+			return value;
+		}
+
+		const Tetromino& placement = worker.generator.getPlacement(best);
+		value += state.apply(placement.getMinos(), placement.getShape(), false) / MCTS_REWARD_SCALE;
+		drawMissing(state, worker.random);
+	}
+
+	return value + getLeafValue(Heuristic::evaluate(state.matrix, 0));
+}
+
+unsigned int Mcts::allocateDecision(const SearchState& state)
+{
+	unsigned int top = m_DecisionTop++;
+
+	if (top >= m_FreeDecisions.size())
+	{
+		return MCTS_NONE;
+	}
+
+	unsigned int index = m_FreeDecisions[top];
+	DecisionNode& node = m_Decisions[index];
+	node.state = state;
+	node.visits = 0;
+	node.expansion = UNEXPANDED;
+	node.firstAction = MCTS_NONE;
+	node.drawCount = 0;
+	node.nextOutcome = MCTS_NONE;
+	return index;
+}
+
+unsigned int Mcts::allocateAction()
+{
+	unsigned int top = m_ActionTop++;
+
+	if (top >= m_FreeActions.size())
+	{
+		return MCTS_NONE;
+	}
+
+	unsigned int index = m_FreeActions[top];
+	ActionNode& action = m_Actions[index];
+	action.visits = 0;
+	action.virtualLoss = 0;
+	action.valueSum = 0;
+	action.nextAction = MCTS_NONE;
+	action.firstOutcome = MCTS_NONE;
+	action.outcomeLock.clear();
+	return index;
+}
+
+/// @brief Replaces the states of a kept subtree with ones built from a state that may know more of the queue.
+/// Outcomes whose draws contradict the newly known pieces are dropped
+void Mcts::refresh(unsigned int decision, const SearchState& state)
+{
+	DecisionNode& node = m_Decisions[decision];
+	SearchState previous = node.state;
+	node.state = state;
+
+	if (node.expansion.load() != EXPANDED)
+	{
+		return;
+	}
+
+	for (unsigned int index = node.firstAction; index != MCTS_NONE; index = m_Actions[index].nextAction)
+	{
+		ActionNode& action = m_Actions[index];
+		std::array<Vector2i, 4> minos = Tetromino::getMinos(action.shape, action.position);
+
+		SearchState before = previous;
+		SearchState after = state;
+		before.apply(minos, action.shape, action.useHold);
+		after.apply(minos, action.shape, action.useHold);
+
+		unsigned int* link = &action.firstOutcome;
+
+		while (*link != MCTS_NONE)
+		{
+			DecisionNode& outcome = m_Decisions[*link];
+			SearchState child = after;
+			std::array<Tetromino::Shape, 2> draws {};
+			unsigned char drawCount = 0;
+			bool consistent = true;
+
+			for (unsigned char i = 0; i < outcome.drawCount && consistent; i++)
+			{
+				unsigned char position = before.queueLength + i;
+
+				if (position < after.queueLength)
+				{
+					consistent = after.queue[position] == outcome.draws[i];
+				}
+				else if (child.getDrawMask() & (1 << outcome.draws[i]))
+				{
+					child.draw(outcome.draws[i]);
+					draws[drawCount++] = outcome.draws[i];
+				}
+				else
+				{
+					consistent = false;
+				}
+			}
+
+			if (!consistent)
+			{
+				*link = outcome.nextOutcome;
+				continue;
+			}
+
+			outcome.draws = draws;
+			outcome.drawCount = drawCount;
+			refresh(*link, child);
+			link = &outcome.nextOutcome;
+		}
+	}
+}
+
+void Mcts::mark(unsigned int decision)
+{
+	m_DecisionMarks[decision] = true;
+
+	if (m_Decisions[decision].expansion.load() != EXPANDED)
+	{
+		return;
+	}
+
+	for (unsigned int action = m_Decisions[decision].firstAction; action != MCTS_NONE; action = m_Actions[action].nextAction)
+	{
+		m_ActionMarks[action] = true;
+
+		for (unsigned int outcome = m_Actions[action].firstOutcome; outcome != MCTS_NONE; outcome = m_Decisions[outcome].nextOutcome)
+		{
+			mark(outcome);
+		}
+	}
+}
+
+/// @brief Returns every node not reachable from the root to the free lists
+void Mcts::collect()
+{
+	std::fill(m_DecisionMarks.begin(), m_DecisionMarks.end(), false);
+	std::fill(m_ActionMarks.begin(), m_ActionMarks.end(), false);
+
+	if (m_Root != MCTS_NONE)
+	{
+		mark(m_Root);
+	}
+
+	m_FreeDecisions.clear();
+	m_FreeActions.clear();
+
+	for (unsigned int i = 0; i < m_DecisionCapacity; i++)
+	{
+		if (!m_DecisionMarks[i])
+		{
+			m_FreeDecisions.push_back(i);
+		}
+	}
+
+	for (unsigned int i = 0; i < m_ActionCapacity; i++)
+	{
+		if (!m_ActionMarks[i])
+		{
+			m_FreeActions.push_back(i);
+		}
+	}
+
+	m_DecisionTop = 0;
+	m_ActionTop = 0;
+}
+
+void Mcts::drawMissing(SearchState& state, unsigned long long& random)
+{
+	while (state.queueLength < 2)
+	{
+		state.drawRandom(random);
+	}
+}
+
+/// @brief Squashes the board heuristic into (0, 1) so it adds up with the scaled line clear rewards
+float Mcts::getLeafValue(float evaluation)
+{
+	return 1 / (1 + std::exp(-(evaluation + 15) * 0.2f));
+}
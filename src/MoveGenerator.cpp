@@ -0,0 +1,115 @@
+#include "Headers/MoveGenerator.hpp"
+
+MoveGenerator::MoveGenerator()
+{
+	m_Queue.reserve(4 * SEARCH_WIDTH * SEARCH_HEIGHT);
+	m_Placements.reserve(4 * SEARCH_WIDTH * SEARCH_HEIGHT);
+	m_PlacementKeys.reserve(4 * SEARCH_WIDTH * SEARCH_HEIGHT);
+}
+
+/// @brief Breadth first search over piece positions. Returns the number of distinct placements found
+unsigned short MoveGenerator::generate(const Matrix& matrix, const Tetromino& tetromino)
+{
+	m_Placements.clear();
+	m_PlacementKeys.clear();
+	m_Queue.clear();
+	m_Visited.reset();
+
+	visit(tetromino);
+	Tetromino next = tetromino;
+
+	for (std::size_t i = 0; i < m_Queue.size(); i++)
+	{
+		Node current = m_Queue[i];
+		next.setPosition(current.position, current.lastKick);
+
+		if (!next.moveDown(matrix))
+		{
+			// Different rotations can rest on the same cells, keep one of them
+			unsigned long long key = getCellKey(next.getMinos());
+
+			if (std::find(m_PlacementKeys.begin(), m_PlacementKeys.end(), key) == m_PlacementKeys.end())
+			{
+				m_Placements.push_back(next);
+				m_PlacementKeys.push_back(key);
+			}
+		}
+		else
+		{
+			visit(next);
+		}
+
+		next.setPosition(current.position, current.lastKick);
+		next.moveLeft(matrix);
+		visit(next);
+
+		next.setPosition(current.position, current.lastKick);
+		next.moveRight(matrix);
+		visit(next);
+
+		next.setPosition(current.position, current.lastKick);
+		next.rotate(true, matrix);
+		visit(next);
+
+		next.setPosition(current.position, current.lastKick);
+		next.rotate(false, matrix);
+		visit(next);
+	}
+
+	return m_Placements.size();
+}
+
+/// @brief Index of the placement covering the same cells, or -1 if it can't be reached
+int MoveGenerator::find(const std::array<Vector2i, 4>& minos)
+{
+	auto position = std::find(m_PlacementKeys.begin(), m_PlacementKeys.end(), getCellKey(minos));
+
+	if (position == m_PlacementKeys.end())
+	{
+		return -1;
+	}
+
+	return position - m_PlacementKeys.begin();
+}
+
+const Tetromino& MoveGenerator::getPlacement(unsigned short index)
+{
+	return m_Placements[index];
+}
+
+unsigned short MoveGenerator::getPlacementCount()
+{
+	return m_Placements.size();
+}
+
+/// @brief Order independent key of the four cells a piece covers. Cell indices run past 255 on the search area, so
+/// each gets 16 bits
+unsigned long long MoveGenerator::getCellKey(const std::array<Vector2i, 4>& minos)
+{
+	std::array<unsigned short, 4> cells;
+
+	for (unsigned char i = 0; i < 4; i++)
+	{
+		cells[i] = (minos[i].y + SEARCH_MARGIN) * SEARCH_WIDTH + minos[i].x + SEARCH_MARGIN;
+	}
+
+	std::sort(cells.begin(), cells.end());
+
+	return cells[0] | (static_cast<unsigned long long>(cells[1]) << 16) | (static_cast<unsigned long long>(cells[2]) << 32) |
+		(static_cast<unsigned long long>(cells[3]) << 48);
+}
+
+/// @brief Queues the piece's position unless it was already seen
+void MoveGenerator::visit(const Tetromino& tetromino)
+{
+	Position position = tetromino.getPosition();
+	unsigned short index = (position.rotation * SEARCH_WIDTH + position.x + SEARCH_MARGIN) * SEARCH_HEIGHT + position.y + SEARCH_MARGIN;
+
+	if (m_Visited[index])
+	{
+		return;
+	}
+
+	m_Visited[index] = true;
+	m_Queue.push_back({ position, tetromino.getLastKick() });
+}
@@ -0,0 +1,222 @@
+#include "Headers/Netplay.hpp"
+
+constexpr sf::Uint32 PACKET_MAGIC = 0x54524953;
+
+NetplayPeer::NetplayPeer(RollbackSession& session) :
+	m_Session(session)
+{
+}
+
+bool NetplayPeer::connect(unsigned short localPort, const sf::IpAddress& remoteAddress, unsigned short remotePort)
+{
+	if (m_Socket.bind(localPort) != sf::Socket::Done)
+	{
+		std::cerr << "Netplay: could not bind UDP port " << localPort << std::endl;
+		return false;
+	}
+
+	m_Socket.setBlocking(false);
+	m_RemoteAddress = remoteAddress;
+	m_RemotePort = remotePort;
+
+	return true;
+}
+
+/// @brief Drains every pending packet and feeds the remote inputs into the session
+void NetplayPeer::receive()
+{
+	sf::Packet packet;
+	sf::IpAddress sender;
+	unsigned short senderPort;
+
+	while (m_Socket.receive(packet, sender, senderPort) == sf::Socket::Done)
+	{
+		sf::Uint32 magic;
+		sf::Int32 ackFrame;
+		sf::Int8 frameAdvantage;
+		sf::Uint32 ping;
+		sf::Uint32 pong;
+		sf::Int32 hashFrame;
+		sf::Uint64 hash;
+		sf::Int32 firstFrame;
+		sf::Uint8 count;
+
+		if (!(packet >> magic >> ackFrame >> frameAdvantage >> ping >> pong >> hashFrame >> hash >> firstFrame >> count) || magic != PACKET_MAGIC)
+		{
+			continue;
+		}
+
+		for (sf::Uint8 i = 0; i < count; i++)
+		{
+			sf::Uint8 input;
+
+			if (!(packet >> input))
+			{
+				break;
+			}
+
+			m_Session.addRemoteInput(firstFrame + i, input);
+		}
+
+		m_Session.addRemoteHash(hashFrame, hash);
+		m_RemoteAckFrame = std::max(m_RemoteAckFrame, static_cast<int>(ackFrame));
+		m_RemoteFrameAdvantage = frameAdvantage;
+		m_LastRemotePing = ping;
+
+		if (pong != 0)
+		{
+			int sample = m_Clock.getElapsedTime().asMilliseconds() - pong;
+			m_RoundTripTime = m_RoundTripTime == 0 ? sample : (7 * m_RoundTripTime + sample) / 8;
+		}
+	}
+
+	int desyncFrame = m_Session.checkDesync();
+
+	if (desyncFrame >= 0 && !m_DesyncReported)
+	{
+		m_DesyncReported = true;
+		std::cerr << "Netplay: desync detected at frame " << desyncFrame << std::endl;
+		m_Session.dumpFrame(desyncFrame, std::cerr);
+	}
+
+	// Inputs arrive half a round trip late, so the remote is already that far past its last received frame
+	int remoteFrame = m_Session.getLastRemoteFrame() + 1 + (m_RoundTripTime * 500 / FRAME_DURATION);
+	m_Session.updateFrameAdvantage(m_Session.getCurrentFrame() - remoteFrame, m_RemoteFrameAdvantage);
+}
+
+void NetplayPeer::sendInputs()
+{
+	int firstFrame = std::max(m_RemoteAckFrame + 1, m_Session.getCurrentFrame() - INPUT_HISTORY);
+	int count = std::min(m_Session.getCurrentFrame() - firstFrame, static_cast<int>(MAX_PACKET_INPUTS));
+
+	int remoteFrame = m_Session.getLastRemoteFrame() + 1 + (m_RoundTripTime * 500 / FRAME_DURATION);
+	int frameAdvantage = std::max(-128, std::min(127, m_Session.getCurrentFrame() - remoteFrame));
+
+	// Zero is reserved for "no ping received yet"
+	sf::Uint32 ping = std::max(1, m_Clock.getElapsedTime().asMilliseconds());
+
+	int hashFrame = m_Session.getConfirmedFrame();
+
+	sf::Packet packet;
+	packet << PACKET_MAGIC
+		   << static_cast<sf::Int32>(m_Session.getLastRemoteFrame())
+		   << static_cast<sf::Int8>(frameAdvantage)
+		   << ping
+		   << m_LastRemotePing
+		   << static_cast<sf::Int32>(hashFrame)
+		   << static_cast<sf::Uint64>(hashFrame >= 0 ? m_Session.getFrameHash(hashFrame) : 0)
+		   << static_cast<sf::Int32>(firstFrame)
+		   << static_cast<sf::Uint8>(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		packet << static_cast<sf::Uint8>(m_Session.getLocalInput(firstFrame + i));
+	}
+
+	m_Socket.send(packet, m_RemoteAddress, m_RemotePort);
+}
+
+/// @brief Smoothed round trip time in milliseconds
+int NetplayPeer::getRoundTripTime()
+{
+	return m_RoundTripTime;
+}
+
+LatencyRelay::LatencyRelay(unsigned short portA, unsigned short portB, unsigned int delayMs, unsigned int jitterMs, unsigned char lossPercent) :
+	m_Ports { portA, portB },
+	m_DelayMs(delayMs),
+	m_JitterMs(jitterMs),
+	m_LossPercent(lossPercent),
+	m_Running(false)
+{
+}
+
+LatencyRelay::~LatencyRelay()
+{
+	stop();
+}
+
+bool LatencyRelay::start()
+{
+	for (unsigned char i = 0; i < 2; i++)
+	{
+		if (m_Sockets[i].bind(m_Ports[i]) != sf::Socket::Done)
+		{
+			std::cerr << "Relay: could not bind UDP port " << m_Ports[i] << std::endl;
+			return false;
+		}
+
+		m_Sockets[i].setBlocking(false);
+	}
+
+	m_Running = true;
+	m_Thread = std::thread(&LatencyRelay::run, this);
+
+	return true;
+}
+
+void LatencyRelay::stop()
+{
+	m_Running = false;
+
+	if (m_Thread.joinable())
+	{
+		m_Thread.join();
+	}
+}
+
+void LatencyRelay::run()
+{
+	std::minstd_rand random(std::random_device {}());
+	sf::SocketSelector selector;
+	selector.add(m_Sockets[0]);
+	selector.add(m_Sockets[1]);
+
+	while (m_Running)
+	{
+		selector.wait(sf::milliseconds(1));
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+		for (unsigned char i = 0; i < 2; i++)
+		{
+			Datagram datagram;
+			sf::IpAddress sender;
+			unsigned short senderPort;
+
+			while (m_Sockets[i].receive(datagram.data.data(), datagram.data.size(), datagram.size, sender, senderPort) == sf::Socket::Done)
+			{
+				// Remember who is behind each port so replies can be forwarded back
+				m_PeerAddresses[i] = sender;
+				m_PeerPorts[i] = senderPort;
+
+				if (random() % 100 < m_LossPercent)
+				{
+					continue;
+				}
+
+				unsigned int jitter = m_JitterMs > 0 ? random() % (m_JitterMs + 1) : 0;
+				datagram.deliverAt = now + std::chrono::milliseconds(m_DelayMs + jitter);
+				datagram.toB = i == 0;
+
+				// Keep the queue sorted by delivery time, jitter may reorder packets like a real network
+				auto position = std::upper_bound(m_Queue.begin(), m_Queue.end(), datagram, [](const Datagram& a, const Datagram& b) {
+					return a.deliverAt < b.deliverAt;
+				});
+				m_Queue.insert(position, datagram);
+			}
+		}
+
+		while (!m_Queue.empty() && m_Queue.front().deliverAt <= now)
+		{
+			Datagram& datagram = m_Queue.front();
+			unsigned char target = datagram.toB ? 1 : 0;
+
+			if (m_PeerPorts[target] != 0)
+			{
+				m_Sockets[target].send(datagram.data.data(), datagram.size, m_PeerAddresses[target], m_PeerPorts[target]);
+			}
+
+			m_Queue.pop_front();
+		}
+	}
+}
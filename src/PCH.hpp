@@ -23,6 +23,8 @@
 
 // Typical stdafx.h
 #include <algorithm>
+#include <array>
+#include <bitset>
 #include <cstdio>
 #include <deque>
 #include <fstream>
@@ -37,16 +39,22 @@
 // Additional C/C++ libs
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <exception>
 #include <functional>
 #include <iomanip>
 #include <mutex>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
 #include <type_traits>
+#include <unordered_set>
 
 // Windows
 #ifdef _WIN32
@@ -0,0 +1,637 @@
+#include "Headers/PerfectClear.hpp"
+#include "Headers/Hash.hpp"
+
+namespace
+{
+constexpr unsigned long long ROW_MASK = (1ULL << COLUMNS) - 1;
+
+constexpr unsigned long long getFieldMask(unsigned char height)
+{
+	return height == 0 ? 0 : (1ULL << (COLUMNS * height)) - 1;
+}
+
+constexpr unsigned long long getColumnMask(unsigned char x)
+{
+	unsigned long long mask = 0;
+
+	for (unsigned char y = 0; y < PERFECT_CLEAR_MAX_HEIGHT; y++)
+	{
+		mask |= 1ULL << (y * COLUMNS + x);
+	}
+
+	return mask;
+}
+
+constexpr unsigned long long EVEN_COLUMNS = getColumnMask(0) | getColumnMask(2) | getColumnMask(4) | getColumnMask(6) | getColumnMask(8);
+}
+
+PerfectClear::PerfectClear(unsigned char threadCount) :
+	m_ThreadCount(threadCount),
+	m_Found(0)
+{
+	if (m_ThreadCount == 0)
+	{
+		m_ThreadCount = std::max(1u, std::min(255u, std::thread::hardware_concurrency()));
+	}
+
+	// Take the footprints from the engine's own rotation states so they can't drift from it
+	static const Matrix empty {};
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		Tetromino tetromino(1);
+		tetromino.reset(static_cast<Tetromino::Shape>(shape), empty);
+
+		for (unsigned char i = 0; i < 4; i++)
+		{
+			tetromino.moveDown(empty);
+		}
+
+		for (unsigned char rotation = 0; rotation < 4; rotation++)
+		{
+			std::array<Vector2i, 4> minos = tetromino.getMinos();
+			int left = COLUMNS;
+			int bottom = 0;
+
+			for (const Vector2i& mino : minos)
+			{
+				left = std::min(left, mino.x);
+				bottom = std::max(bottom, mino.y);
+			}
+
+			Footprint footprint {};
+
+			for (unsigned char m = 0; m < 4; m++)
+			{
+				footprint.cells[m] = Vector2i(minos[m].x - left, bottom - minos[m].y);
+				footprint.width = std::max<unsigned char>(footprint.width, footprint.cells[m].x + 1);
+				footprint.height = std::max<unsigned char>(footprint.height, footprint.cells[m].y + 1);
+			}
+
+			std::sort(footprint.cells.begin(), footprint.cells.end(), [](const Vector2i& a, const Vector2i& b) {
+				return a.y != b.y ? a.y < b.y : a.x < b.x;
+			});
+
+			// I, S and Z cover the same cells in opposite rotations
+			bool duplicate = std::any_of(m_Footprints[shape].begin(), m_Footprints[shape].end(), [&](const Footprint& other) {
+				return other.cells == footprint.cells;
+			});
+
+			if (!duplicate)
+			{
+				m_Footprints[shape].push_back(footprint);
+			}
+
+			tetromino.rotate(true, empty);
+		}
+	}
+
+	// Every way a piece can end up covering cells of a field, counting rows cleared between its own rows
+	for (unsigned char height = 1; height <= PERFECT_CLEAR_MAX_HEIGHT; height++)
+	{
+		for (unsigned char shape = 0; shape < 7; shape++)
+		{
+			for (const Footprint& footprint : m_Footprints[shape])
+			{
+				for (unsigned char rowMask = 0; rowMask < (1 << height); rowMask++)
+				{
+					if (__builtin_popcount(rowMask) != footprint.height)
+					{
+						continue;
+					}
+
+					std::array<unsigned char, 4> rows;
+
+					for (unsigned char row = 0, i = 0; row < height; row++)
+					{
+						if (rowMask & (1 << row))
+						{
+							rows[i++] = row;
+						}
+					}
+
+					for (unsigned char x = 0; x + footprint.width <= COLUMNS; x++)
+					{
+						unsigned long long cells = 0;
+
+						for (const Vector2i& cell : footprint.cells)
+						{
+							cells |= 1ULL << (rows[cell.y] * COLUMNS + x + cell.x);
+						}
+
+						m_Coverings[height][shape].push_back(cells);
+					}
+				}
+			}
+		}
+	}
+}
+
+/// @brief Looks for placements that clear the bottom height rows within maxPieces pieces of the state's queue and
+/// hold. Fails straight away if anything sits above those rows
+bool PerfectClear::solve(const SearchState& state, unsigned char maxPieces, unsigned char height, std::vector<PerfectClearMove>& solution)
+{
+	solution.clear();
+	m_Nodes = 0;
+
+	if (height == 0 || height > PERFECT_CLEAR_MAX_HEIGHT)
+	{
+		return false;
+	}
+
+	Node root { 0, height, 0, state.hold, 0 };
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		for (unsigned char y = 0; y < ROWS; y++)
+		{
+			if (state.matrix[x][y] == 0)
+			{
+				continue;
+			}
+
+			if (ROWS - 1 - y >= height)
+			{
+				return false;
+			}
+
+			root.board |= 1ULL << ((ROWS - 1 - y) * COLUMNS + x);
+		}
+	}
+
+	m_Queue = state.queue;
+	m_QueueLength = state.queueLength;
+	m_MaxPieces = maxPieces;
+
+	// Full rows at the start don't need a piece
+	root = place(root, Placement { 0, 0, Tetromino::Shape::I, false, 0, state.hold });
+
+	if (root.height == 0)
+	{
+		return true;
+	}
+
+	std::vector<Placement> branches;
+	getPlacements(root, branches);
+
+	std::vector<Placement> path;
+
+	if (!searchBranches(root, branches, path))
+	{
+		return false;
+	}
+
+	for (const Placement& placement : path)
+	{
+		solution.push_back({ placement.shape, placement.useHold, getMinos(placement.cells) });
+	}
+
+	return true;
+}
+
+/// @brief Searches below each first placement on the thread pool. Workers take branches in order and a success
+/// stops every branch after it, so the answer is the same whatever the thread count
+bool PerfectClear::searchBranches(const Node& root, const std::vector<Placement>& branches, std::vector<Placement>& path)
+{
+	std::atomic<unsigned int> nextBranch(0);
+	std::vector<std::vector<Placement>> paths(branches.size());
+	m_Found = branches.size();
+
+	auto work = [&]() {
+		Worker worker;
+		worker.placements.resize(m_MaxPieces + 1);
+
+		for (unsigned int branch = nextBranch++; branch < branches.size() && static_cast<int>(branch) < m_Found; branch = nextBranch++)
+		{
+			worker.branch = branch;
+			worker.path.assign(1, branches[branch]);
+
+			if (search(worker, place(root, branches[branch]), 1))
+			{
+				paths[branch] = worker.path;
+
+				int found = m_Found;
+
+				while (static_cast<int>(branch) < found && !m_Found.compare_exchange_weak(found, branch))
+				{
+				}
+			}
+		}
+
+		return worker.nodes;
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<unsigned long long> nodes(m_ThreadCount);
+
+	for (unsigned char i = 1; i < m_ThreadCount; i++)
+	{
+		threads.emplace_back([&, i]() { nodes[i] = work(); });
+	}
+
+	nodes[0] = work();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (unsigned long long count : nodes)
+	{
+		m_Nodes += count;
+	}
+
+	if (m_Found == static_cast<int>(branches.size()))
+	{
+		return false;
+	}
+
+	path = paths[m_Found];
+	return true;
+}
+
+unsigned long long PerfectClear::getNodeCount() const
+{
+	return m_Nodes;
+}
+
+std::size_t PerfectClear::NodeHash::operator()(const Node& node) const
+{
+	return finalizeHash(hashWord(node.board, node.height | node.index << 8 | node.hold << 16));
+}
+
+bool PerfectClear::NodeEqual::operator()(const Node& a, const Node& b) const
+{
+	return a.board == b.board && a.height == b.height && a.index == b.index && a.hold == b.hold;
+}
+
+/// @brief Depth first over the node's placements. The path is left holding the placements of the solution
+bool PerfectClear::search(Worker& worker, const Node& node, unsigned char depth)
+{
+	if (node.height == 0)
+	{
+		return true;
+	}
+
+	worker.nodes++;
+
+	// Every empty cell needs a quarter of a piece
+	unsigned int emptyCells = COLUMNS * node.height - __builtin_popcountll(node.board);
+	unsigned int available = m_QueueLength - node.index + (node.hold != NO_HOLD);
+
+	if (emptyCells % 4 != 0 || emptyCells / 4 > std::min<unsigned int>(available, m_MaxPieces - node.placed))
+	{
+		return false;
+	}
+
+	if (hasParityConflict(node, emptyCells / 4) || worker.failures.count(node) > 0 || hasDeadRegion(node, worker.fits))
+	{
+		return false;
+	}
+
+	std::vector<Placement>& placements = worker.placements[depth];
+	getPlacements(node, placements);
+
+	for (const Placement& placement : placements)
+	{
+		worker.path.push_back(placement);
+
+		if (search(worker, place(node, placement), depth + 1))
+		{
+			return true;
+		}
+
+		worker.path.pop_back();
+
+		// An earlier branch already has a solution
+		if (static_cast<int>(worker.branch) > m_Found)
+		{
+			return false;
+		}
+	}
+
+	worker.failures.insert(node);
+	return false;
+}
+
+/// @brief Placements of the current piece and of the piece hold would give, in search order
+void PerfectClear::getPlacements(const Node& node, std::vector<Placement>& placements) const
+{
+	getPieces(node, placements);
+
+	std::stable_sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b) { return a.order < b.order; });
+}
+
+void PerfectClear::getPieces(const Node& node, std::vector<Placement>& placements) const
+{
+	placements.clear();
+
+	if (node.index >= m_QueueLength)
+	{
+		if (node.hold != NO_HOLD)
+		{
+			// The queue ran out, only the held piece is left
+			addPlacements(node, static_cast<Tetromino::Shape>(node.hold), true, node.index, NO_HOLD, placements);
+		}
+
+		return;
+	}
+
+	Tetromino::Shape current = m_Queue[node.index];
+	addPlacements(node, current, false, node.index + 1, node.hold, placements);
+
+	if (node.hold == NO_HOLD)
+	{
+		if (node.index + 1 < m_QueueLength && m_Queue[node.index + 1] != current)
+		{
+			addPlacements(node, m_Queue[node.index + 1], true, node.index + 2, current, placements);
+		}
+	}
+	else if (node.hold != current)
+	{
+		addPlacements(node, static_cast<Tetromino::Shape>(node.hold), true, node.index + 1, current, placements);
+	}
+}
+
+/// @brief Flood fills each footprint down from above the field with shifts and soft drops, keeping the positions
+/// where the piece rests inside the field
+void PerfectClear::addPlacements(const Node& node, Tetromino::Shape shape, bool useHold, unsigned char nextIndex, unsigned char nextHold,
+	std::vector<Placement>& placements) const
+{
+	std::size_t first = placements.size();
+
+	for (const Footprint& footprint : m_Footprints[shape])
+	{
+		if (footprint.height > node.height)
+		{
+			continue;
+		}
+
+		unsigned char columns = COLUMNS - footprint.width + 1;
+		// Positions by bottom row, from 0 up to just above the field
+		unsigned char rows = node.height + 1;
+		std::array<unsigned long long, COLUMNS * (PERFECT_CLEAR_MAX_HEIGHT + 1)> masks {};
+		std::bitset<COLUMNS * (PERFECT_CLEAR_MAX_HEIGHT + 1)> open;
+		std::bitset<COLUMNS * (PERFECT_CLEAR_MAX_HEIGHT + 1)> visited;
+
+		for (unsigned char y = 0; y < rows; y++)
+		{
+			for (unsigned char x = 0; x < columns; x++)
+			{
+				unsigned long long mask = 0;
+				bool fits = true;
+
+				for (const Vector2i& cell : footprint.cells)
+				{
+					unsigned char cellY = y + cell.y;
+
+					if (cellY < node.height)
+					{
+						unsigned long long bit = 1ULL << (cellY * COLUMNS + x + cell.x);
+						fits = fits && (node.board & bit) == 0;
+						mask |= bit;
+					}
+				}
+
+				masks[y * COLUMNS + x] = mask;
+				open[y * COLUMNS + x] = fits;
+			}
+		}
+
+		// Start anywhere above the field, where rotating is free
+		std::array<unsigned char, COLUMNS * (PERFECT_CLEAR_MAX_HEIGHT + 1)> queue;
+		unsigned char queueSize = 0;
+
+		for (unsigned char x = 0; x < columns; x++)
+		{
+			visited[node.height * COLUMNS + x] = true;
+			queue[queueSize++] = node.height * COLUMNS + x;
+		}
+
+		for (unsigned char i = 0; i < queueSize; i++)
+		{
+			unsigned char position = queue[i];
+			unsigned char x = position % COLUMNS;
+			unsigned char y = position / COLUMNS;
+
+			if (y == 0 || !open[position - COLUMNS])
+			{
+				// Resting here, only useful if the whole piece is inside the field
+				if (y + footprint.height <= node.height)
+				{
+					unsigned long long cells = masks[position];
+
+					bool duplicate = std::any_of(placements.begin() + first, placements.end(), [cells](const Placement& other) {
+						return other.cells == cells;
+					});
+
+					if (!duplicate)
+					{
+						placements.push_back({ cells, getOrder(cells), shape, useHold, nextIndex, nextHold });
+					}
+				}
+			}
+			else if (!visited[position - COLUMNS])
+			{
+				visited[position - COLUMNS] = true;
+				queue[queueSize++] = position - COLUMNS;
+			}
+
+			if (x > 0 && open[position - 1] && !visited[position - 1])
+			{
+				visited[position - 1] = true;
+				queue[queueSize++] = position - 1;
+			}
+
+			if (x + 1 < columns && open[position + 1] && !visited[position + 1])
+			{
+				visited[position + 1] = true;
+				queue[queueSize++] = position + 1;
+			}
+		}
+	}
+}
+
+/// @brief Perfect clears mostly fill from the bottom up, so try low placements first
+unsigned char PerfectClear::getOrder(unsigned long long cells)
+{
+	unsigned char height = 0;
+
+	for (; cells != 0; cells &= cells - 1)
+	{
+		height += __builtin_ctzll(cells) / COLUMNS;
+	}
+
+	return height;
+}
+
+/// @brief Adds a placement's cells and collapses the rows it completes
+PerfectClear::Node PerfectClear::place(const Node& node, const Placement& placement)
+{
+	Node next = node;
+	next.board |= placement.cells;
+	next.index = placement.nextIndex;
+	next.hold = placement.nextHold;
+	next.placed += placement.cells != 0;
+
+	unsigned long long board = 0;
+	unsigned char height = 0;
+
+	for (unsigned char y = 0; y < node.height; y++)
+	{
+		unsigned long long row = (next.board >> (y * COLUMNS)) & ROW_MASK;
+
+		if (row != ROW_MASK)
+		{
+			board |= row << (height++ * COLUMNS);
+		}
+	}
+
+	next.board = board;
+	next.height = height;
+	return next;
+}
+
+/// @brief True if no choice of the pieces left can fill the difference between empty cells in even and odd columns.
+/// I covers a difference of 0 or 4, T of 0 or 2, J and L always 2 and the rest 0. Line clears remove as many cells
+/// from even as from odd columns, so this holds all the way down
+bool PerfectClear::hasParityConflict(const Node& node, unsigned char pieces) const
+{
+	unsigned long long empty = ~node.board & getFieldMask(node.height);
+	int difference = std::abs(__builtin_popcountll(empty & EVEN_COLUMNS) - __builtin_popcountll(empty & ~EVEN_COLUMNS));
+
+	// The pieces that can still be played, with one of them left over when there are more than needed
+	std::array<unsigned char, SEARCH_QUEUE + 1> pool;
+	unsigned char poolSize = 0;
+
+	if (node.hold != NO_HOLD)
+	{
+		pool[poolSize++] = node.hold;
+	}
+
+	for (unsigned char i = node.index; i < m_QueueLength && poolSize <= pieces; i++)
+	{
+		pool[poolSize++] = m_Queue[i];
+	}
+
+	for (unsigned char skip = 0; skip < poolSize; skip++)
+	{
+		if (poolSize > pieces && skip == poolSize)
+		{
+			break;
+		}
+
+		int maximum = 0;
+		unsigned char t = 0;
+		unsigned char jl = 0;
+
+		for (unsigned char i = 0; i < poolSize; i++)
+		{
+			if (poolSize > pieces && i == skip)
+			{
+				continue;
+			}
+
+			maximum += pool[i] == Tetromino::Shape::I ? 4 : 0;
+			t += pool[i] == Tetromino::Shape::T;
+			jl += pool[i] == Tetromino::Shape::J || pool[i] == Tetromino::Shape::L;
+		}
+
+		maximum += 2 * (t + jl);
+
+		if (difference <= maximum && (t > 0 || (difference - 2 * jl) % 4 == 0))
+		{
+			return false;
+		}
+
+		// Every piece is used, there is no other choice to try
+		if (poolSize <= pieces)
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+/// @brief True if some empty cell can't be filled by the pieces left. A piece placed later may have rows cleared
+/// between its own, so its cells are matched against every spread of its rows over the field. Cells that such a
+/// piece could cover together form a region, and every region has to be filled by whole pieces
+bool PerfectClear::hasDeadRegion(const Node& node, std::vector<unsigned long long>& fits) const
+{
+	unsigned long long empty = ~node.board & getFieldMask(node.height);
+	unsigned long long coverable = 0;
+	unsigned char shapes = node.hold != NO_HOLD ? 1 << node.hold : 0;
+
+	for (unsigned char i = node.index; i < m_QueueLength; i++)
+	{
+		shapes |= 1 << m_Queue[i];
+	}
+
+	fits.clear();
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		if ((shapes & (1 << shape)) == 0)
+		{
+			continue;
+		}
+
+		for (unsigned long long cells : m_Coverings[node.height][shape])
+		{
+			if ((cells & node.board) == 0)
+			{
+				coverable |= cells;
+				fits.push_back(cells);
+			}
+		}
+	}
+
+	if ((empty & ~coverable) != 0)
+	{
+		return true;
+	}
+
+	while (empty != 0)
+	{
+		unsigned long long region = empty & (~empty + 1);
+		unsigned long long previous = 0;
+
+		while (region != previous)
+		{
+			previous = region;
+
+			for (unsigned long long cells : fits)
+			{
+				if ((cells & region) != 0)
+				{
+					region |= cells;
+				}
+			}
+		}
+
+		if (__builtin_popcountll(region) % 4 != 0)
+		{
+			return true;
+		}
+
+		empty &= ~region;
+	}
+
+	return false;
+}
+
+/// @brief Board coordinates of a placement's cells, rows counted from the bottom of the field
+std::array<Vector2i, 4> PerfectClear::getMinos(unsigned long long cells)
+{
+	std::array<Vector2i, 4> minos;
+
+	for (unsigned char i = 0; i < 4; i++)
+	{
+		unsigned char bit = __builtin_ctzll(cells);
+		minos[i] = Vector2i(bit % COLUMNS, ROWS - 1 - bit / COLUMNS);
+		cells &= cells - 1;
+	}
+
+	return minos;
+}
@@ -10,7 +10,7 @@ namespace util
  *****************************************************************************/
 LinuxPlatform::LinuxPlatform()
 {
-	// TODO: Investigate further
+	// The render thread draws while the main thread polls events, so Xlib has to be thread safe before its first call
 	XInitThreads();
 }
 
@@ -0,0 +1,165 @@
+#include "Headers/Replay.hpp"
+
+constexpr char REPLAY_MAGIC[4] = { 'T', 'R', 'P', 'L' };
+constexpr unsigned char REPLAY_VERSION = 6;
+// An input byte and a hash per frame
+constexpr unsigned char REPLAY_FRAME_SIZE = 9;
+
+namespace
+{
+// Replays are stored little endian regardless of the host
+void writeInteger(std::ostream& out, unsigned long long value, unsigned char size)
+{
+	for (unsigned char i = 0; i < size; i++)
+	{
+		out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+}
+
+unsigned long long readInteger(std::istream& in, unsigned char size)
+{
+	unsigned long long value = 0;
+
+	for (unsigned char i = 0; i < size; i++)
+	{
+		value |= static_cast<unsigned long long>(static_cast<unsigned char>(in.get())) << (8 * i);
+	}
+
+	return value;
+}
+}
+
+Replay::Replay(unsigned long long seed) :
+	m_Seed(seed)
+{
+}
+
+/// @brief Appends one frame, the hash is the session hash after stepping with the input
+void Replay::record(unsigned char input, unsigned long long hash)
+{
+	m_Inputs.push_back(input);
+	m_Hashes.push_back(hash);
+}
+
+bool Replay::save(const std::string& path)
+{
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+	writeInteger(file, REPLAY_VERSION, 1);
+	writeInteger(file, m_Seed, 8);
+	writeInteger(file, m_Handling.das, 2);
+	writeInteger(file, m_Handling.arr, 2);
+	writeInteger(file, m_Handling.softDropFactor, 1);
+	writeInteger(file, m_Inputs.size(), 4);
+
+	for (std::size_t frame = 0; frame < m_Inputs.size(); frame++)
+	{
+		writeInteger(file, m_Inputs[frame], 1);
+		writeInteger(file, m_Hashes[frame], 8);
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool Replay::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	char magic[sizeof(REPLAY_MAGIC)];
+
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 || readInteger(file, 1) != REPLAY_VERSION)
+	{
+		return false;
+	}
+
+	m_Seed = readInteger(file, 8);
+	m_Handling.das = readInteger(file, 2);
+	m_Handling.arr = readInteger(file, 2);
+	m_Handling.softDropFactor = readInteger(file, 1);
+	unsigned int frameCount = readInteger(file, 4);
+
+	// The count comes from the file, so check the frames are all there before allocating for them
+	std::streampos framesStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff remaining = file.tellg() - framesStart;
+	file.seekg(framesStart);
+
+	if (!file || remaining < static_cast<std::streamoff>(frameCount) * REPLAY_FRAME_SIZE)
+	{
+		return false;
+	}
+
+	m_Inputs.resize(frameCount);
+	m_Hashes.resize(frameCount);
+
+	for (unsigned int frame = 0; frame < frameCount; frame++)
+	{
+		m_Inputs[frame] = readInteger(file, 1);
+		m_Hashes[frame] = readInteger(file, 8);
+	}
+
+	return static_cast<bool>(file);
+}
+
+/// @brief Replays the inputs and compares the hash every frame.
+/// Returns the first divergent frame after writing both states to the report, or -1 if the replay matches
+int Replay::verify(std::ostream& report)
+{
+	GameSession session(m_Seed);
+	session.handling = m_Handling;
+	GameSession previous = session;
+
+	for (int frame = 0; frame < getFrameCount(); frame++)
+	{
+		session.save(previous);
+		session.step(m_Inputs[frame]);
+
+		if (session.hash() != m_Hashes[frame])
+		{
+			report << "Replay diverged at frame " << frame << ": recorded hash " << std::hex << m_Hashes[frame] << std::dec << '\n'
+				   << "State before the frame:\n";
+			previous.dump(report);
+			report << "State after the frame with input " << static_cast<int>(m_Inputs[frame]) << ":\n";
+			session.dump(report);
+			return frame;
+		}
+	}
+
+	return -1;
+}
+
+unsigned long long Replay::getSeed()
+{
+	return m_Seed;
+}
+
+/// @brief Sets the handling the game is played with, the session's auto shift depends on it
+void Replay::setHandling(const Handling& handling)
+{
+	m_Handling = handling;
+}
+
+const Handling& Replay::getHandling()
+{
+	return m_Handling;
+}
+
+int Replay::getFrameCount()
+{
+	return m_Inputs.size();
+}
+
+unsigned char Replay::getInput(int frame)
+{
+	return m_Inputs[frame];
+}
+
+unsigned long long Replay::getHash(int frame)
+{
+	return m_Hashes[frame];
+}
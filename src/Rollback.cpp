@@ -0,0 +1,237 @@
+#include "Headers/Rollback.hpp"
+#include "Headers/Hash.hpp"
+
+RollbackSession::RollbackSession(unsigned char localPlayer, unsigned long long seed) :
+	m_Players { GameSession(seed), GameSession(seed + 1) },
+	m_LocalPlayer(localPlayer)
+{
+	m_LocalInputs.fill(0);
+	m_RemoteInputs.fill(0);
+	m_Hashes.fill(0);
+	m_LocalAdvantages.fill(0);
+	m_RemoteAdvantages.fill(0);
+
+	for (Snapshot& snapshot : m_Snapshots)
+	{
+		snapshot.frame = -1;
+	}
+
+	for (RemoteHash& remoteHash : m_RemoteHashes)
+	{
+		remoteHash.frame = -1;
+	}
+}
+
+/// @brief False while the prediction window is exhausted and the session has to wait for remote inputs
+bool RollbackSession::canAdvance()
+{
+	return m_CurrentFrame - m_LastRemoteFrame <= MAX_ROLLBACK_FRAMES;
+}
+
+/// @brief Resimulates from the first mispredicted frame if needed, then simulates the current frame
+void RollbackSession::advanceFrame(unsigned char localInput)
+{
+	m_LastRollbackFrames = 0;
+
+	if (m_FirstMispredictedFrame >= 0)
+	{
+		Snapshot& snapshot = m_Snapshots[m_FirstMispredictedFrame % m_Snapshots.size()];
+		assert(snapshot.frame == m_FirstMispredictedFrame);
+
+		m_Players[0].restore(snapshot.players[0]);
+		m_Players[1].restore(snapshot.players[1]);
+
+		for (int frame = m_FirstMispredictedFrame; frame < m_CurrentFrame; frame++)
+		{
+			simulateFrame(frame);
+		}
+
+		m_LastRollbackFrames = m_CurrentFrame - m_FirstMispredictedFrame;
+		m_FirstMispredictedFrame = -1;
+	}
+
+	m_LocalInputs[m_CurrentFrame % INPUT_HISTORY] = localInput;
+	simulateFrame(m_CurrentFrame);
+	m_CurrentFrame++;
+}
+
+/// @brief Confirms the remote input for a frame. Inputs must arrive in order, duplicates and gaps are ignored
+void RollbackSession::addRemoteInput(int frame, unsigned char input)
+{
+	if (frame != m_LastRemoteFrame + 1)
+	{
+		return;
+	}
+
+	unsigned char& storedInput = m_RemoteInputs[frame % INPUT_HISTORY];
+
+	// Frames already simulated used a prediction, schedule a rollback if it was wrong
+	if (frame < m_CurrentFrame && storedInput != input && m_FirstMispredictedFrame < 0)
+	{
+		m_FirstMispredictedFrame = frame;
+	}
+
+	storedInput = input;
+	m_LastRemoteFrame = frame;
+}
+
+void RollbackSession::addRemoteHash(int frame, unsigned long long hash)
+{
+	if (frame >= 0)
+	{
+		m_RemoteHashes[frame % INPUT_HISTORY] = { frame, hash };
+	}
+}
+
+/// @brief Compares remote hashes against local ones for frames confirmed on both sides.
+/// Returns the first frame where the games diverged, or -1
+int RollbackSession::checkDesync()
+{
+	int confirmedFrame = getConfirmedFrame();
+	int desyncFrame = -1;
+
+	for (RemoteHash& remoteHash : m_RemoteHashes)
+	{
+		// Wait until the frame is final locally, and skip frames too old to still have a hash
+		if (remoteHash.frame < 0 || remoteHash.frame > confirmedFrame)
+		{
+			continue;
+		}
+
+		if (remoteHash.frame > m_CurrentFrame - INPUT_HISTORY && m_Hashes[remoteHash.frame % INPUT_HISTORY] != remoteHash.hash)
+		{
+			if (desyncFrame < 0 || remoteHash.frame < desyncFrame)
+			{
+				desyncFrame = remoteHash.frame;
+			}
+		}
+
+		remoteHash.frame = -1;
+	}
+
+	return desyncFrame;
+}
+
+/// @brief Writes both games as they were after the given frame, or the current games if that is too old
+void RollbackSession::dumpFrame(int frame, std::ostream& out)
+{
+	Snapshot& snapshot = m_Snapshots[(frame + 1) % m_Snapshots.size()];
+
+	for (unsigned char player = 0; player < 2; player++)
+	{
+		if (snapshot.frame == frame + 1)
+		{
+			out << "Player " << static_cast<int>(player) << " after frame " << frame << ":\n";
+			snapshot.players[player].dump(out);
+		}
+		else
+		{
+			out << "Player " << static_cast<int>(player) << " at frame " << m_CurrentFrame << ":\n";
+			m_Players[player].dump(out);
+		}
+	}
+}
+
+/// @brief Records how many frames each side thinks it is ahead of the other, sampled once per frame
+void RollbackSession::updateFrameAdvantage(int localAdvantage, int remoteAdvantage)
+{
+	unsigned char index = m_CurrentFrame % TIME_SYNC_WINDOW;
+	m_LocalAdvantages[index] = std::max(-128, std::min(127, localAdvantage));
+	m_RemoteAdvantages[index] = std::max(-128, std::min(127, remoteAdvantage));
+}
+
+/// @brief Frames the local side should idle so both sides run at the same point in time
+int RollbackSession::getRecommendedWaitFrames()
+{
+	int localSum = 0;
+	int remoteSum = 0;
+
+	for (unsigned char i = 0; i < TIME_SYNC_WINDOW; i++)
+	{
+		localSum += m_LocalAdvantages[i];
+		remoteSum += m_RemoteAdvantages[i];
+	}
+
+	// Splitting the difference lets both sides meet in the middle
+	float waitFrames = (localSum - remoteSum) / (2.0f * TIME_SYNC_WINDOW);
+
+	if (waitFrames < MIN_FRAME_ADVANTAGE)
+	{
+		return 0;
+	}
+
+	return std::min(static_cast<int>(waitFrames + 0.5f), static_cast<int>(MAX_FRAME_WAIT));
+}
+
+int RollbackSession::getCurrentFrame()
+{
+	return m_CurrentFrame;
+}
+
+int RollbackSession::getLastRemoteFrame()
+{
+	return m_LastRemoteFrame;
+}
+
+/// @brief Last frame whose inputs are known from both sides and whose simulation won't be rolled back
+int RollbackSession::getConfirmedFrame()
+{
+	int confirmedFrame = std::min(m_LastRemoteFrame, m_CurrentFrame - 1);
+
+	if (m_FirstMispredictedFrame >= 0)
+	{
+		confirmedFrame = std::min(confirmedFrame, m_FirstMispredictedFrame - 1);
+	}
+
+	return confirmedFrame;
+}
+
+/// @brief Hash of both games after the given frame, only meaningful for recent frames
+unsigned long long RollbackSession::getFrameHash(int frame)
+{
+	return m_Hashes[frame % INPUT_HISTORY];
+}
+
+unsigned char RollbackSession::getLocalInput(int frame)
+{
+	return m_LocalInputs[frame % INPUT_HISTORY];
+}
+
+unsigned char RollbackSession::getLocalPlayer()
+{
+	return m_LocalPlayer;
+}
+
+/// @brief Number of frames resimulated by the last call to advanceFrame
+unsigned char RollbackSession::getLastRollbackFrames()
+{
+	return m_LastRollbackFrames;
+}
+
+GameSession& RollbackSession::getPlayer(unsigned char player)
+{
+	return m_Players[player];
+}
+
+void RollbackSession::simulateFrame(int frame)
+{
+	Snapshot& snapshot = m_Snapshots[frame % m_Snapshots.size()];
+	snapshot.frame = frame;
+	m_Players[0].save(snapshot.players[0]);
+	m_Players[1].save(snapshot.players[1]);
+
+	unsigned char& remoteInput = m_RemoteInputs[frame % INPUT_HISTORY];
+
+	// Predict that the remote player keeps holding whatever they last confirmed
+	if (frame > m_LastRemoteFrame)
+	{
+		remoteInput = m_LastRemoteFrame >= 0 ? m_RemoteInputs[m_LastRemoteFrame % INPUT_HISTORY] : 0;
+	}
+
+	unsigned char localInput = m_LocalInputs[frame % INPUT_HISTORY];
+
+	m_Players[m_LocalPlayer].step(localInput);
+	m_Players[1 - m_LocalPlayer].step(remoteInput);
+
+	m_Hashes[frame % INPUT_HISTORY] = finalizeHash(hashWord(m_Players[0].hash(), m_Players[1].hash()));
+}
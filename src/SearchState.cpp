@@ -0,0 +1,137 @@
+#include "Headers/SearchState.hpp"
+#include "Headers/Hash.hpp"
+#include "Headers/Heuristic.hpp"
+
+/// @brief What the player sees of a live game: the current piece, one preview and the bag implied by past draws
+SearchState SearchState::fromSession(const GameSession& session)
+{
+	SearchState state {};
+
+	state.matrix = session.matrix;
+	state.queue[0] = session.tetromino.getShape();
+	state.queue[1] = session.tetromino.getNextShape();
+	state.queueLength = 2;
+	state.hold = session.tetromino.isHolding() ? static_cast<unsigned char>(session.tetromino.getHoldingShape()) : NO_HOLD;
+	state.bag = session.tetromino.getBagMask();
+	state.level = session.level;
+
+	return state;
+}
+
+/// @brief Spawns the piece that would be played, the current one or the one hold brings in. False if there is none
+/// or it is blocked
+bool SearchState::getPiece(bool useHold, Tetromino& piece) const
+{
+	Tetromino::Shape shape;
+
+	if (!useHold)
+	{
+		if (queueLength == 0)
+		{
+			return false;
+		}
+
+		shape = queue[0];
+	}
+	else if (hold != NO_HOLD)
+	{
+		shape = static_cast<Tetromino::Shape>(hold);
+	}
+	else
+	{
+		// Holding into an empty slot plays the next piece
+		if (queueLength < 2)
+		{
+			return false;
+		}
+
+		shape = queue[1];
+	}
+
+	return piece.reset(shape, matrix);
+}
+
+/// @brief Locks a placement from getPiece and removes the pieces it used from the queue. Returns the score gained
+int SearchState::apply(const std::array<Vector2i, 4>& minos, Tetromino::Shape shape, bool useHold)
+{
+	unsigned char used = 1;
+
+	if (useHold)
+	{
+		used = hold == NO_HOLD ? 2 : 1;
+		hold = queue[0];
+	}
+
+	unsigned char linesCleared = Heuristic::lock(matrix, minos, 1 + shape);
+	int score = Heuristic::getLineClearScore(linesCleared, level);
+
+	std::move(queue.begin() + used, queue.begin() + queueLength, queue.begin());
+	queueLength -= used;
+
+	return score;
+}
+
+/// @brief Shapes the next draw can be
+unsigned char SearchState::getDrawMask() const
+{
+	return bag == 0 ? FULL_BAG : bag;
+}
+
+/// @brief Appends a drawn shape to the queue and takes it out of the bag, the same way SevenBagRandomizer::draw does
+void SearchState::draw(Tetromino::Shape shape)
+{
+	bag = getDrawMask() & ~(1 << shape);
+
+	if (queueLength < SEARCH_QUEUE)
+	{
+		queue[queueLength++] = shape;
+	}
+}
+
+/// @brief Draws uniformly from what is left in the bag using a caller owned xorshift state
+Tetromino::Shape SearchState::drawRandom(unsigned long long& random)
+{
+	random ^= random >> 12;
+	random ^= random << 25;
+	random ^= random >> 27;
+
+	unsigned char mask = getDrawMask();
+	unsigned char pick = ((random * 0x2545F4914F6CDD1DULL) >> 32) % __builtin_popcount(mask);
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		if ((mask & (1 << shape)) && pick-- == 0)
+		{
+			draw(static_cast<Tetromino::Shape>(shape));
+			return static_cast<Tetromino::Shape>(shape);
+		}
+	}
+
+	return Tetromino::Shape::I;
+}
+
+/// @brief Hash of the occupied cells, queue, hold and bag. Mino colours are left out since they don't change the game
+unsigned long long SearchState::hash() const
+{
+	std::array<StandardBoard::Row, ROWS> rows {};
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		for (unsigned char y = 0; y < ROWS; y++)
+		{
+			rows[y] |= (matrix[x][y] != 0) << x;
+		}
+	}
+
+	unsigned long long pieces = hold | static_cast<unsigned long long>(bag) << 8 | static_cast<unsigned long long>(level) << 16 |
+		static_cast<unsigned long long>(queueLength) << 24;
+
+	unsigned long long hash = hashBytes(0, rows.data(), sizeof(rows));
+	hash = hashBytes(hash, queue.data(), queueLength);
+	return finalizeHash(hashWord(hash, pieces));
+}
+
+bool SearchState::operator==(const SearchState& other) const
+{
+	return std::memcmp(this, &other, sizeof(SearchState)) == 0;
+}
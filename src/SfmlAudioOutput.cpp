@@ -0,0 +1,92 @@
+#include "Headers/SfmlAudioOutput.hpp"
+
+constexpr unsigned int AUDIO_SAMPLE_RATE = 44100;
+
+namespace
+{
+/// @brief Square wave sliding from one pitch to another with a linear fade out
+std::vector<sf::Int16> synthesizeTone(float fromHz, float toHz, float seconds, float volume)
+{
+	std::vector<sf::Int16> samples(static_cast<std::size_t>(seconds * AUDIO_SAMPLE_RATE));
+	double phase = 0;
+
+	for (std::size_t i = 0; i < samples.size(); i++)
+	{
+		float progress = static_cast<float>(i) / samples.size();
+		phase += (fromHz + (toHz - fromHz) * progress) / AUDIO_SAMPLE_RATE;
+
+		float wave = phase - std::floor(phase) < 0.5 ? 1.0f : -1.0f;
+		samples[i] = static_cast<sf::Int16>(wave * volume * (1 - progress) * 32767);
+	}
+
+	return samples;
+}
+}
+
+SfmlAudioOutput::SfmlAudioOutput(const AssetArchive& assets) :
+	m_Assets(assets)
+{
+}
+
+bool SfmlAudioOutput::load()
+{
+	const char* names[SOUND_EFFECTS] = { "move", "rotate", "lock", "clear", "levelup" };
+	// From pitch, to pitch, length and volume of the stand in for each effect
+	const float tones[SOUND_EFFECTS][4] = {
+		{ 880, 880, 0.03f, 0.15f },
+		{ 660, 990, 0.05f, 0.15f },
+		{ 220, 110, 0.08f, 0.25f },
+		{ 440, 1760, 0.25f, 0.25f },
+		{ 330, 1320, 0.5f, 0.3f }
+	};
+
+	for (unsigned char effect = 0; effect < SOUND_EFFECTS; effect++)
+	{
+		std::string name = std::string("sounds/") + names[effect] + ".wav";
+		AssetSpan asset;
+		bool isPacked = m_Assets.find(name, asset);
+
+		if (isPacked || util::fs::exists("content/" + name))
+		{
+			if (isPacked ? !m_Buffers[effect].loadFromMemory(asset.data, asset.size) : !m_Buffers[effect].loadFromFile("content/" + name))
+			{
+				std::cerr << "Could not decode " << name << std::endl;
+				return false;
+			}
+
+			continue;
+		}
+
+		std::vector<sf::Int16> samples = synthesizeTone(tones[effect][0], tones[effect][1], tones[effect][2], tones[effect][3]);
+
+		if (!m_Buffers[effect].loadFromSamples(samples.data(), samples.size(), 1, AUDIO_SAMPLE_RATE))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// @brief Starts the effect on a free voice, or on the oldest one if they are all playing
+void SfmlAudioOutput::play(SoundEffect effect)
+{
+	sf::Sound* voice = &m_Voices[m_NextVoice];
+
+	for (sf::Sound& candidate : m_Voices)
+	{
+		if (candidate.getStatus() == sf::Sound::Stopped)
+		{
+			voice = &candidate;
+			break;
+		}
+	}
+
+	if (voice == &m_Voices[m_NextVoice])
+	{
+		m_NextVoice = (m_NextVoice + 1) % AUDIO_VOICES;
+	}
+
+	voice->setBuffer(m_Buffers[effect]);
+	voice->play();
+}
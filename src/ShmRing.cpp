@@ -0,0 +1,354 @@
+#ifdef __linux__
+	#include "Headers/ShmRing.hpp"
+
+	#include <climits>
+	#include <fcntl.h>
+	#include <linux/futex.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+
+constexpr unsigned int SHM_RING_MAGIC = 0x474E4952;
+constexpr unsigned int SHM_RING_SPINS = 256;
+// Largest power of two an unsigned int holds, capacities round up to one
+constexpr unsigned int SHM_RING_MAX_CAPACITY = 1u << 31;
+
+/// @brief Lives at the start of the shared segment. Producer and consumer fields are on separate cache lines
+struct ShmRingHeader
+{
+	unsigned int magic;
+	unsigned int slotSize;
+	unsigned int capacity;
+	std::atomic<unsigned int> closed;
+
+	alignas(64) std::atomic<unsigned int> head;
+	std::atomic<unsigned int> consumerWaiting;
+
+	alignas(64) std::atomic<unsigned int> tail;
+	std::atomic<unsigned int> producerWaiting;
+};
+
+static_assert(std::atomic<unsigned int>::is_always_lock_free, "Ring indices must be lock-free to be shared between processes");
+
+namespace
+{
+// Shared futexes, not FUTEX_PRIVATE, since the two sides are different processes
+void futexWait(std::atomic<unsigned int>& word, unsigned int expected)
+{
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+void futexWake(std::atomic<unsigned int>& word)
+{
+	syscall(SYS_futex, reinterpret_cast<unsigned int*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void relax()
+{
+	#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+	#endif
+}
+
+/// @brief Blocks until the other side moves its index away from seen, or the ring is closed.
+/// The waiting flag and the index form a Dekker pair with the other side's publish, so no wakeup is lost
+unsigned int waitForChange(ShmRingHeader& header, std::atomic<unsigned int>& index, std::atomic<unsigned int>& waiting, unsigned int seen)
+{
+	for (unsigned int spin = 0; spin < SHM_RING_SPINS; spin++)
+	{
+		unsigned int current = index.load(std::memory_order_acquire);
+
+		if (current != seen || header.closed.load(std::memory_order_relaxed))
+		{
+			return current;
+		}
+
+		relax();
+	}
+
+	while (true)
+	{
+		waiting.store(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		unsigned int current = index.load(std::memory_order_acquire);
+
+		if (current != seen || header.closed.load(std::memory_order_relaxed))
+		{
+			waiting.store(0, std::memory_order_relaxed);
+			return current;
+		}
+
+		futexWait(index, seen);
+	}
+}
+
+void publish(std::atomic<unsigned int>& index, std::atomic<unsigned int>& otherWaiting, unsigned int value)
+{
+	index.store(value, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (otherWaiting.load(std::memory_order_relaxed))
+	{
+		otherWaiting.store(0, std::memory_order_relaxed);
+		futexWake(index);
+	}
+}
+}
+
+ShmRing::~ShmRing()
+{
+	detach();
+}
+
+/// @brief Creates and owns the segment. Either side may create it. Capacity is rounded up to a power of two so indices can wrap freely
+bool ShmRing::create(const std::string& name, unsigned int slotSize, unsigned int capacity)
+{
+	detach();
+
+	if (capacity == 0 || capacity > SHM_RING_MAX_CAPACITY)
+	{
+		std::cerr << "Shared memory ring capacity " << capacity << " is out of range" << std::endl;
+		return false;
+	}
+
+	unsigned int roundedCapacity = 1;
+
+	while (roundedCapacity < capacity)
+	{
+		roundedCapacity <<= 1;
+	}
+
+	int descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+
+	if (descriptor < 0)
+	{
+		std::cerr << "Could not create shared memory " << name << std::endl;
+		return false;
+	}
+
+	m_SlotStride = (slotSize + 63) / 64 * 64;
+	std::size_t size = (sizeof(ShmRingHeader) + 63) / 64 * 64 + m_SlotStride * roundedCapacity;
+
+	if (ftruncate(descriptor, size) != 0 || !map(descriptor, size))
+	{
+		::close(descriptor);
+		shm_unlink(name.c_str());
+		std::cerr << "Could not size shared memory " << name << std::endl;
+		return false;
+	}
+
+	::close(descriptor);
+
+	m_Header->slotSize = slotSize;
+	m_Header->capacity = roundedCapacity;
+	m_Header->closed.store(0);
+	m_Header->head.store(0);
+	m_Header->consumerWaiting.store(0);
+	m_Header->tail.store(0);
+	m_Header->producerWaiting.store(0);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_Header->magic = SHM_RING_MAGIC;
+
+	m_Name = name;
+	m_Owner = true;
+
+	return true;
+}
+
+/// @brief Attaches to a ring made by create in another process
+bool ShmRing::open(const std::string& name)
+{
+	detach();
+
+	int descriptor = shm_open(name.c_str(), O_RDWR, 0600);
+	struct stat info;
+
+	if (descriptor < 0 || fstat(descriptor, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(ShmRingHeader)
+		|| !map(descriptor, info.st_size))
+	{
+		if (descriptor >= 0)
+		{
+			::close(descriptor);
+		}
+
+		std::cerr << "Could not open shared memory " << name << std::endl;
+		return false;
+	}
+
+	::close(descriptor);
+
+	if (m_Header->magic != SHM_RING_MAGIC)
+	{
+		std::cerr << "Shared memory " << name << " is not a ring" << std::endl;
+		detach();
+		return false;
+	}
+
+	m_SlotStride = (m_Header->slotSize + 63) / 64 * 64;
+	unsigned int capacity = m_Header->capacity;
+
+	// The header comes from the other process, its slots have to fit in what was mapped
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0
+		|| static_cast<std::size_t>(m_Slots - reinterpret_cast<unsigned char*>(m_Header)) + m_SlotStride * capacity > m_MappedSize)
+	{
+		std::cerr << "Shared memory " << name << " does not hold the ring its header describes" << std::endl;
+		detach();
+		return false;
+	}
+
+	m_Name = name;
+
+	return true;
+}
+
+/// @brief Tells the other side no more slots are coming and wakes it if it sleeps
+void ShmRing::close()
+{
+	if (m_Header == nullptr)
+	{
+		return;
+	}
+
+	m_Header->closed.store(1, std::memory_order_release);
+	futexWake(m_Header->head);
+	futexWake(m_Header->tail);
+}
+
+/// @brief Unmaps the ring, the creator also removes the name
+void ShmRing::detach()
+{
+	if (m_Header != nullptr)
+	{
+		munmap(m_Header, m_MappedSize);
+	}
+
+	if (m_Owner)
+	{
+		shm_unlink(m_Name.c_str());
+	}
+
+	m_Header = nullptr;
+	m_Slots = nullptr;
+	m_Owner = false;
+	m_Position = 0;
+	m_CachedOther = 0;
+}
+
+/// @brief Next free slot, waits while the ring is full. Returns nullptr once the ring is closed
+void* ShmRing::beginWrite()
+{
+	if (m_Position - m_CachedOther == m_Header->capacity)
+	{
+		m_CachedOther = m_Header->tail.load(std::memory_order_acquire);
+
+		while (m_Position - m_CachedOther == m_Header->capacity)
+		{
+			if (m_Header->closed.load(std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+
+			m_CachedOther = waitForChange(*m_Header, m_Header->tail, m_Header->producerWaiting, m_CachedOther);
+		}
+	}
+
+	return m_Slots + (m_Position & (m_Header->capacity - 1)) * m_SlotStride;
+}
+
+void ShmRing::endWrite()
+{
+	publish(m_Header->head, m_Header->consumerWaiting, ++m_Position);
+}
+
+/// @brief Oldest filled slot, waits while the ring is empty. Returns nullptr once the ring is closed and drained
+const void* ShmRing::beginRead()
+{
+	if (m_Position == m_CachedOther)
+	{
+		m_CachedOther = m_Header->head.load(std::memory_order_acquire);
+
+		while (m_Position == m_CachedOther)
+		{
+			if (m_Header->closed.load(std::memory_order_acquire))
+			{
+				// The producer may have published right before closing
+				m_CachedOther = m_Header->head.load(std::memory_order_acquire);
+
+				if (m_Position == m_CachedOther)
+				{
+					return nullptr;
+				}
+
+				break;
+			}
+
+			m_CachedOther = waitForChange(*m_Header, m_Header->head, m_Header->consumerWaiting, m_CachedOther);
+		}
+	}
+
+	return m_Slots + (m_Position & (m_Header->capacity - 1)) * m_SlotStride;
+}
+
+void ShmRing::endRead()
+{
+	publish(m_Header->tail, m_Header->producerWaiting, ++m_Position);
+}
+
+bool ShmRing::push(const void* data)
+{
+	void* slot = beginWrite();
+
+	if (slot == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(slot, data, m_Header->slotSize);
+	endWrite();
+
+	return true;
+}
+
+bool ShmRing::pop(void* data)
+{
+	const void* slot = beginRead();
+
+	if (slot == nullptr)
+	{
+		return false;
+	}
+
+	std::memcpy(data, slot, m_Header->slotSize);
+	endRead();
+
+	return true;
+}
+
+unsigned int ShmRing::getSlotSize() const
+{
+	return m_Header->slotSize;
+}
+
+unsigned int ShmRing::getCapacity() const
+{
+	return m_Header->capacity;
+}
+
+bool ShmRing::map(int descriptor, std::size_t size)
+{
+	void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+	if (memory == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_Header = static_cast<ShmRingHeader*>(memory);
+	m_Slots = static_cast<unsigned char*>(memory) + (sizeof(ShmRingHeader) + 63) / 64 * 64;
+	m_MappedSize = size;
+
+	return true;
+}
+#endif // __linux__
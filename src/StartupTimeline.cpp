@@ -0,0 +1,74 @@
+#include "Headers/StartupTimeline.hpp"
+
+StartupTimeline::StartupTimeline(Clock::time_point launch) :
+	m_Launch(launch)
+{
+}
+
+void StartupTimeline::mark(const char* stage)
+{
+	mark(stage, Clock::now());
+}
+
+void StartupTimeline::mark(const char* stage, Clock::time_point time)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (m_Count < STARTUP_STAGES)
+	{
+		m_Stages[m_Count++] = { stage, time };
+	}
+}
+
+unsigned char StartupTimeline::getStageCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Count;
+}
+
+/// @brief Milliseconds from launch to the first mark of the stage, negative when it was never marked
+double StartupTimeline::getElapsed(const std::string& stage) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (unsigned char i = 0; i < m_Count; i++)
+	{
+		if (stage == m_Stages[i].name)
+		{
+			return std::chrono::duration<double, std::milli>(m_Stages[i].time - m_Launch).count();
+		}
+	}
+
+	return -1;
+}
+
+/// @brief One line per stage, "startup <stage> <ms since launch> <ms since the previous stage>"
+void StartupTimeline::report(std::ostream& out) const
+{
+	std::array<Stage, STARTUP_STAGES> stages;
+	unsigned char count;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		stages = m_Stages;
+		count = m_Count;
+	}
+
+	// Background stages can finish out of order
+	std::stable_sort(stages.begin(), stages.begin() + count, [](const Stage& a, const Stage& b)
+	{
+		return a.time < b.time;
+	});
+
+	Clock::time_point previous = m_Launch;
+	out << std::fixed << std::setprecision(2);
+
+	for (unsigned char i = 0; i < count; i++)
+	{
+		out << "startup " << stages[i].name << ' ' << std::chrono::duration<double, std::milli>(stages[i].time - m_Launch).count() << ' '
+			<< std::chrono::duration<double, std::milli>(stages[i].time - previous).count() << std::endl;
+		previous = stages[i].time;
+	}
+
+	out << std::defaultfloat;
+}
@@ -0,0 +1,257 @@
+#include "Headers/TetrisCore.h"
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+#include "Headers/ShmRing.hpp"
+#include "Headers/VecEnv.hpp"
+
+struct TetrisSession
+{
+	GameSession game;
+	MoveGenerator generator;
+	// Placements go stale as soon as the active piece changes
+	bool hasPlacements;
+};
+
+struct TetrisVecEnv
+{
+	VecEnv env;
+};
+
+#ifdef __linux__
+struct TetrisRing
+{
+	ShmRing ring;
+};
+#endif
+
+static_assert(TETRIS_BOARD_COLUMNS == COLUMNS && TETRIS_BOARD_ROWS == ROWS, "TetrisCore.h board size is out of date");
+static_assert(TETRIS_MAX_PLACEMENTS == 4 * COLUMNS * ROWS, "TETRIS_MAX_PLACEMENTS must cover every rotation and cell");
+
+uint32_t tetris_abi_version(void)
+{
+	return TETRIS_CORE_ABI_VERSION;
+}
+
+TetrisSession* tetris_session_create(uint64_t seed)
+{
+	TetrisSession* session = new TetrisSession { GameSession(seed), MoveGenerator(), false };
+	session->game.currentGameState = GameState::IN_PROGRESS;
+
+	return session;
+}
+
+void tetris_session_destroy(TetrisSession* session)
+{
+	delete session;
+}
+
+/// @brief Steps several frames in one call so the per call overhead is paid once
+void tetris_session_step(TetrisSession* session, const uint8_t* inputs, uint32_t frames)
+{
+	for (uint32_t i = 0; i < frames; i++)
+	{
+		session->game.step(inputs[i]);
+	}
+
+	session->hasPlacements = false;
+}
+
+uint8_t tetris_session_state(const TetrisSession* session)
+{
+	return session->game.currentGameState;
+}
+
+int32_t tetris_session_score(const TetrisSession* session)
+{
+	return session->game.score;
+}
+
+int32_t tetris_session_lines(const TetrisSession* session)
+{
+	return session->game.totalLinesCleared;
+}
+
+uint64_t tetris_session_hash(const TetrisSession* session)
+{
+	return session->game.hash();
+}
+
+uint32_t tetris_snapshot_size(void)
+{
+	return sizeof(GameSession);
+}
+
+void tetris_session_snapshot(const TetrisSession* session, void* snapshot)
+{
+	std::memcpy(snapshot, static_cast<const void*>(&session->game), sizeof(GameSession));
+}
+
+void tetris_session_restore(TetrisSession* session, const void* snapshot)
+{
+	std::memcpy(static_cast<void*>(&session->game), snapshot, sizeof(GameSession));
+	session->hasPlacements = false;
+}
+
+void tetris_session_board(const TetrisSession* session, uint8_t* cells)
+{
+	for (unsigned char y = 0; y < ROWS; y++)
+	{
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			cells[y * COLUMNS + x] = session->game.matrix[x][y];
+		}
+	}
+}
+
+uint32_t tetris_session_placements(TetrisSession* session, TetrisPlacement* placements, uint32_t capacity)
+{
+	uint32_t count = std::min<uint32_t>(session->generator.generate(session->game.matrix, session->game.tetromino), capacity);
+	session->hasPlacements = true;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const Tetromino& placement = session->generator.getPlacement(i);
+		std::array<Vector2i, 4> minos = placement.getMinos();
+
+		placements[i].shape = placement.getShape();
+		placements[i].rotation = placement.getRotation();
+
+		for (unsigned char j = 0; j < 4; j++)
+		{
+			placements[i].cells[j][0] = minos[j].x;
+			placements[i].cells[j][1] = minos[j].y;
+		}
+	}
+
+	return count;
+}
+
+int32_t tetris_session_place(TetrisSession* session, uint32_t index)
+{
+	if (!session->hasPlacements || index >= session->generator.getPlacementCount() || session->game.currentGameState != GameState::IN_PROGRESS)
+	{
+		return -1;
+	}
+
+	session->hasPlacements = false;
+
+	return session->game.place(session->generator.getPlacement(index));
+}
+
+int32_t tetris_session_hold(TetrisSession* session)
+{
+	session->hasPlacements = false;
+
+	return session->game.hold();
+}
+
+TetrisVecEnv* tetris_vecenv_create(uint32_t count, uint64_t seed, uint32_t max_pieces)
+{
+	return new TetrisVecEnv { VecEnv(count, seed, max_pieces) };
+}
+
+void tetris_vecenv_destroy(TetrisVecEnv* env)
+{
+	delete env;
+}
+
+uint32_t tetris_vecenv_observation_size(void)
+{
+	return VECENV_OBSERVATION_SIZE;
+}
+
+uint32_t tetris_vecenv_action_count(void)
+{
+	return VECENV_ACTIONS;
+}
+
+void tetris_vecenv_reset(TetrisVecEnv* env, uint8_t* observations)
+{
+	env->env.reset(observations);
+}
+
+void tetris_vecenv_step(TetrisVecEnv* env, const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones)
+{
+	env->env.step(actions, observations, rewards, dones);
+}
+
+#ifdef __linux__
+TetrisRing* tetris_ring_create(const char* name, uint32_t slot_size, uint32_t capacity)
+{
+	TetrisRing* ring = new TetrisRing;
+
+	if (!ring->ring.create(name, slot_size, capacity))
+	{
+		delete ring;
+		return nullptr;
+	}
+
+	return ring;
+}
+
+TetrisRing* tetris_ring_open(const char* name)
+{
+	TetrisRing* ring = new TetrisRing;
+
+	if (!ring->ring.open(name))
+	{
+		delete ring;
+		return nullptr;
+	}
+
+	return ring;
+}
+
+void tetris_ring_close(TetrisRing* ring)
+{
+	ring->ring.close();
+}
+
+void tetris_ring_destroy(TetrisRing* ring)
+{
+	delete ring;
+}
+
+void* tetris_ring_begin_write(TetrisRing* ring)
+{
+	return ring->ring.beginWrite();
+}
+
+void tetris_ring_end_write(TetrisRing* ring)
+{
+	ring->ring.endWrite();
+}
+
+const void* tetris_ring_begin_read(TetrisRing* ring)
+{
+	return ring->ring.beginRead();
+}
+
+void tetris_ring_end_read(TetrisRing* ring)
+{
+	ring->ring.endRead();
+}
+
+uint32_t tetris_transition_size(void)
+{
+	return sizeof(Transition);
+}
+
+int32_t tetris_vecenv_step_to_ring(TetrisVecEnv* env, const uint8_t* actions, TetrisRing* ring)
+{
+	for (unsigned int i = 0; i < env->env.getCount(); i++)
+	{
+		void* slot = ring->ring.beginWrite();
+
+		if (slot == nullptr)
+		{
+			return 0;
+		}
+
+		env->env.step(i, actions[i], *static_cast<Transition*>(slot));
+		ring->ring.endWrite();
+	}
+
+	return 1;
+}
+#endif
@@ -1,191 +1,192 @@
 #include "Headers/Tetromino.hpp"
 #include "Headers/Global.hpp"
+#include "Headers/Hash.hpp"
+#include "Headers/Rules.hpp"
 #include <iostream>
-#include <vector>
 
-std::vector<Tetromino::Shape> availableShapes = {
-	Tetromino::Shape::I,
-	Tetromino::Shape::J,
-	Tetromino::Shape::L,
-	Tetromino::Shape::O,
-	Tetromino::Shape::S,
-	Tetromino::Shape::T,
-	Tetromino::Shape::Z,
-};
+namespace
+{
+// SRS wall kick offsets, tried in order until one fits
+const std::array<Vector2i, TETROMINO_KICKS> kicksI01 = { { { 0, 0 }, { -2, 0 }, { 1, 0 }, { -2, 1 }, { 1, -2 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksI03 = { { { 0, 0 }, { -1, 0 }, { 2, 0 }, { -1, -2 }, { 2, 1 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksI10 = { { { 0, 0 }, { 2, 0 }, { -1, 0 }, { 2, -1 }, { -1, 2 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksI21 = { { { 0, 0 }, { 1, 0 }, { -2, 0 }, { 1, 2 }, { -2, -1 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksCW = { { { 0, 0 }, { -1, 0 }, { -1, -1 }, { 0, 2 }, { -1, 2 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksCCW = { { { 0, 0 }, { 1, 0 }, { 1, -1 }, { 0, 2 }, { 1, 2 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksFrom1 = { { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, -2 }, { 1, -2 } } };
+const std::array<Vector2i, TETROMINO_KICKS> kicksFrom3 = { { { 0, 0 }, { -1, 0 }, { -1, 1 }, { 0, -2 }, { -1, -2 } } };
+// Rotation systems with fewer kicks repeat the in place offset, which fails again
+const std::array<Vector2i, TETROMINO_KICKS> kicksNone = {};
+const std::array<Vector2i, TETROMINO_KICKS> kicksArs = { { { 0, 0 }, { 1, 0 }, { -1, 0 }, { 0, 0 }, { 0, 0 } } };
+
+// Shapes the TGM randomizer remembers and how many times it rolls to avoid them
+constexpr unsigned char TGM_HISTORY = 4;
+constexpr unsigned char TGM_ROLLS = 4;
+
+/// @brief xorshift64*, the state lives in the piece so it can be copied with memcpy
+unsigned int nextRandom(unsigned long long& random)
+{
+	random ^= random >> 12;
+	random ^= random << 25;
+	random ^= random >> 27;
+
+	return static_cast<unsigned int>((random * 0x2545F4914F6CDD1DULL) >> 32);
+}
+}
 
-/// @brief Gets the tetromino of a given shape
-std::vector<sf::Vector2i> Tetromino::getTetromino(Shape shape, unsigned char x, unsigned char y)
+/// @brief Gets the tetromino of a given shape in its spawn orientation around a cell
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getTetromino(Shape shape, unsigned char x, unsigned char y)
 {
-	std::vector<sf::Vector2i> outputTetromino(4);
+	return getMinos(shape, { static_cast<signed char>(x), static_cast<signed char>(y), 0 });
+}
 
-	switch (shape)
-	{
-		// I
-		case Shape::I: {
-			outputTetromino[0] = { 1, -1 };
-			outputTetromino[1] = { 0, -1 };
-			outputTetromino[2] = { -1, -1 };
-			outputTetromino[3] = { -2, -1 };
-			break;
-		}
-		// L
-		case Shape::L: {
-			outputTetromino[0] = { 0, 0 };
-			outputTetromino[1] = { 1, 0 };
-			outputTetromino[2] = { -1, -1 };
-			outputTetromino[3] = { -1, 0 };
-			break;
-		}
-		// J
-		case Shape::J: {
-			outputTetromino[0] = { 0, 0 };
-			outputTetromino[1] = { 1, 0 };
-			outputTetromino[2] = { 1, -1 };
-			outputTetromino[3] = { -1, 0 };
-			break;
-		}
-		// O
-		case Shape::O: {
-			outputTetromino[0] = { 0, 0 };
-			outputTetromino[1] = { 0, -1 };
-			outputTetromino[2] = { -1, -1 };
-			outputTetromino[3] = { -1, 0 };
-			break;
-		}
-		// S
-		case Shape::S: {
-			outputTetromino[0] = { 0, 0 };
-			outputTetromino[1] = { 1, -1 };
-			outputTetromino[2] = { 0, -1 };
-			outputTetromino[3] = { -1, 0 };
-			break;
-		}
-		// T
-		case Shape::T: {
-			outputTetromino[0] = { 0, 1 };
-			outputTetromino[1] = { 0, 0 };
-			outputTetromino[2] = { -1, 1 };
-			outputTetromino[3] = { 1, 1 };
-			break;
-		}
-		// Z
-		case Shape::Z: {
-			outputTetromino[0] = { 0, 0 };
-			outputTetromino[1] = { 1, 0 };
-			outputTetromino[2] = { 0, -1 };
-			outputTetromino[3] = { -1, -1 };
-			break;
-		}
-		default:
-			break;
-	}
+/// @brief The cells a shape covers at a position
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getMinos(Shape shape, Position position)
+{
+	std::array<Vector2i, 4> minos = TETROMINO_FOOTPRINTS[shape][position.rotation];
+	Vector2i origin(position.x, position.y);
 
-	for (sf::Vector2i& mino : outputTetromino)
+	for (Vector2i& mino : minos)
 	{
-		mino.x += x;
-		mino.y += y;
+		mino = mino + origin;
 	}
 
-	return outputTetromino;
+	return minos;
 }
 
-Tetromino::Tetromino() :
-	m_Rotation(0)
+template <typename Rules>
+BasicTetromino<Rules>::BasicTetromino() :
+	BasicTetromino(std::chrono::system_clock::now().time_since_epoch().count())
 {
-	m_Random.seed(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+template <typename Rules>
+BasicTetromino<Rules>::BasicTetromino(unsigned long long seed) :
+	m_Position { Board::SPAWN_X, Board::SPAWN_Y, 0 },
+	m_HoldShape(Shape::I)
+{
+	// Spread the seed so that nearby seeds give unrelated sequences, xorshift state must never be zero
+	m_Random = finalizeHash(seed + 0x9E3779B97F4A7C15ULL) | 1;
 
 	m_Shape = selectRandomShape();
 	m_NextShape = selectRandomShape();
-	m_Minos = getTetromino(m_Shape, COLUMNS / 2, 1);
 }
 
-bool Tetromino::moveDown(const std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+bool BasicTetromino<Rules>::moveDown(const Matrix& matrix)
 {
-	for (sf::Vector2i mino : m_Minos)
+	// Check for collision with bottom of grid or with the rest of the already placed tetrominos
+	if (!Board::fits(matrix, getMinos(), { 0, 1 }))
 	{
-		// Check for collision with bottom of grid or with the rest of the already placed tetrominos
-		if (ROWS == 1 + mino.y || matrix[mino.x][1 + mino.y] > 0)
-		{
-			return false;
-		}
+		return false;
 	}
 
 	// Shift tetromino down
-	for (sf::Vector2i& mino : m_Minos)
-	{
-		mino.y++;
-	}
+	m_Position.y++;
+
+	m_LastKick = 0;
 
 	return true;
 }
 
-bool Tetromino::reset(const std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+bool BasicTetromino<Rules>::reset(const Matrix& matrix)
 {
 	auto tempShape = m_NextShape;
 	m_NextShape = selectRandomShape();
 	return reset(tempShape, matrix);
 }
 
-bool Tetromino::reset(Tetromino::Shape shape, const std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+bool BasicTetromino<Rules>::reset(Shape shape, const Matrix& matrix)
 {
-	m_Rotation = 0;
 	m_Shape = shape;
+	m_LastKick = 0;
 
-	// Get tetromino with the next shape and locate it at the top center
-	m_Minos = getTetromino(m_Shape, COLUMNS / 2, 1);
+	// Locate the next shape at the top center
+	m_Position = { Board::SPAWN_X, Board::SPAWN_Y, 0 };
 
-	for (sf::Vector2i mino : m_Minos)
-	{
-		// Check if the starting location is occupied
-		if (matrix[mino.x][mino.y] > 0)
-		{
-			return false;
-		}
-	}
-
-	return true;
+	// Check if the starting location is occupied
+	return Board::fits(matrix, getMinos(), { 0, 0 });
 }
 
-Tetromino::Shape Tetromino::getShape()
+template <typename Rules>
+TetrominoShapes::Shape BasicTetromino<Rules>::getShape() const
 {
 	return m_Shape;
 }
 
-void Tetromino::moveLeft(const std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+void BasicTetromino<Rules>::moveLeft(const Matrix& matrix)
 {
-	for (sf::Vector2i mino : m_Minos)
+	// Check for collision out of bounds or with another already placed tetromino
+	if (!Board::fits(matrix, getMinos(), { -1, 0 }))
 	{
-		// Check for collision out of bounds or with another already placed tetrominio
-		if (mino.x - 1 < 0 || (mino.y > 0 && matrix[mino.x - 1][mino.y] > 0))
-		{
-			return;
-		}
+		return;
 	}
 
-	for (sf::Vector2i& mino : m_Minos)
+	m_Position.x--;
+
+	m_LastKick = 0;
+}
+
+template <typename Rules>
+void BasicTetromino<Rules>::moveRight(const Matrix& matrix)
+{
+	// Check for collision out of bounds or with another already placed tetromino
+	if (!Board::fits(matrix, getMinos(), { 1, 0 }))
 	{
-		mino.x--;
+		return;
 	}
+
+	m_Position.x++;
+
+	m_LastKick = 0;
 }
 
-void Tetromino::moveRight(const std::vector<std::vector<unsigned char>>& matrix)
+/// @brief Columns the piece can shift in a direction, -1 for left, before it hits the wall or the stack
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::getShiftDistance(signed char direction, const Matrix& matrix) const
 {
-	for (sf::Vector2i mino : m_Minos)
+	int distance = COLUMNS;
+
+	for (const Vector2i& mino : getMinos())
 	{
-		// Check for collision out of bounds or with another already placed tetrominio
-		if (mino.x + 1 > 9 || (mino.y > 0 && matrix[mino.x + 1][mino.y] > 0))
+		int x = mino.x + direction;
+
+		while (x >= 0 && x < COLUMNS && (mino.y < 0 || matrix[x][mino.y] == 0))
 		{
-			return;
+			x += direction;
 		}
+
+		distance = std::min(distance, (x - mino.x) * direction - 1);
 	}
 
-	for (sf::Vector2i& mino : m_Minos)
+	return distance;
+}
+
+/// @brief Shifts up to the given number of columns in one step, returns how many it moved
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::shift(signed char direction, unsigned char columns, const Matrix& matrix)
+{
+	unsigned char distance = std::min(columns, getShiftDistance(direction, matrix));
+
+	if (distance == 0)
 	{
-		mino.x++;
+		return 0;
 	}
+
+	m_Position.x += direction * distance;
+
+	m_LastKick = 0;
+
+	return distance;
 }
 
-void Tetromino::rotate(bool clockwise, const std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+void BasicTetromino<Rules>::rotate(bool clockwise, const Matrix& matrix)
 {
 	// Don't need to rotate Os
 	if (m_Shape == Shape::O)
@@ -197,316 +198,412 @@ void Tetromino::rotate(bool clockwise, const std::vector<std::vector<unsigned ch
 
 	if (!clockwise)
 	{
-		nextRotation = (3 + m_Rotation) % 4;
+		nextRotation = (3 + m_Position.rotation) % 4;
 	}
 	else
 	{
-		nextRotation = (1 + m_Rotation) % 4;
+		nextRotation = (1 + m_Position.rotation) % 4;
 	}
 
-	std::vector<sf::Vector2i> currentMinos = m_Minos;
+	std::array<Vector2i, 4> turnedMinos = getMinos(m_Shape, { m_Position.x, m_Position.y, nextRotation });
+	const std::array<Vector2i, TETROMINO_KICKS>& kicks = getWallKickData(nextRotation);
 
-	if (m_Shape == Shape::I)
+	for (unsigned char kick = 0; kick < TETROMINO_KICKS; kick++)
 	{
-		// I rotation is a specific location
-		float centerX = 0.5f * (m_Minos[1].x + m_Minos[2].x);
-		float centerY = 0.5f * (m_Minos[1].y + m_Minos[2].y);
+		const Vector2i& wallKickPoint = kicks[kick];
 
-		if (m_Rotation == 0)
+		if (Board::fits(matrix, turnedMinos, wallKickPoint))
 		{
-			centerY += 0.5f;
-		}
-		else if (m_Rotation == 1)
-		{
-			centerX -= 0.5f;
-		}
-		else if (m_Rotation == 2)
-		{
-			centerY -= 0.5f;
+			m_Position.x += wallKickPoint.x;
+			m_Position.y += wallKickPoint.y;
+			m_Position.rotation = nextRotation;
+			m_LastKick = kick + 1;
+
+			return;
 		}
-		else if (m_Rotation == 3)
+	}
+}
+
+template <typename Rules>
+void BasicTetromino<Rules>::updateMatrix(Matrix& matrix)
+{
+	for (const Vector2i& mino : getMinos())
+	{
+		// Only a piece that locks out reaches above the matrix, and the game ends with it
+		if (mino.y < 0)
 		{
-			centerX += 0.5f;
+			continue;
 		}
 
-		for (sf::Vector2i& mino : m_Minos)
-		{
-			float x = mino.x - centerX;
-			float y = mino.y - centerY;
+		matrix[mino.x][mino.y] = 1 + getShape();
+	}
+}
 
-			if (clockwise)
-			{
-				mino.x = static_cast<char>(centerX - y);
-				mino.y = static_cast<char>(centerY + x);
-			}
-			else
-			{
-				mino.x = static_cast<char>(centerX + y);
-				mino.y = static_cast<char>(centerY - x);
-			}
-		}
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getMinos() const
+{
+	return getMinos(m_Shape, m_Position);
+}
+
+template <typename Rules>
+Position BasicTetromino<Rules>::getPosition() const
+{
+	return m_Position;
+}
+
+/// @brief Moves the piece straight to a position, for search that keeps positions rather than whole pieces. lastKick is
+/// what getLastKick should report there, 0 unless the piece got there by rotating
+template <typename Rules>
+void BasicTetromino<Rules>::setPosition(Position position, unsigned char lastKick)
+{
+	m_Position = position;
+	m_LastKick = lastKick;
+}
+
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::getRotation() const
+{
+	return m_Position.rotation;
+}
+
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::getLastKick() const
+{
+	return m_LastKick;
+}
+
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getGhostMinos(const Matrix& matrix)
+{
+	std::array<Vector2i, 4> ghostMinos = getMinos();
+	unsigned char distance = getDropDistance(matrix);
+
+	for (Vector2i& mino : ghostMinos)
+	{
+		mino.y += distance;
 	}
-	else
+
+	return ghostMinos;
+}
+
+/// @brief Rows the piece can fall before it lands, from the first filled cell under its lowest mino in each column
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::getDropDistance(const Matrix& matrix) const
+{
+	std::array<int, COLUMNS> bottoms;
+	bottoms.fill(-ROWS);
+
+	for (const Vector2i& mino : getMinos())
 	{
-		for (unsigned char i = 1; i < m_Minos.size(); i++)
+		bottoms[mino.x] = std::max(bottoms[mino.x], mino.y);
+	}
+
+	int distance = ROWS;
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		if (bottoms[x] == -ROWS)
 		{
-			char x = m_Minos[i].x - m_Minos[0].x;
-			char y = m_Minos[i].y - m_Minos[0].y;
+			continue;
+		}
 
-			if (clockwise)
-			{
-				m_Minos[i].x = m_Minos[0].x - y;
-				m_Minos[i].y = x + m_Minos[0].y;
-			}
-			else
-			{
-				m_Minos[i].x = y + m_Minos[0].x;
-				m_Minos[i].y = m_Minos[0].y - x;
-			}
+		int y = std::max(bottoms[x] + 1, 0);
+
+		while (y < ROWS && matrix[x][y] == 0)
+		{
+			y++;
 		}
+
+		distance = std::min(distance, y - bottoms[x] - 1);
 	}
 
-	for (sf::Vector2i& wallKickPoint : getWallKickData(nextRotation))
+	return distance;
+}
+
+/// @brief Falls up to the given number of rows in one step, returns how many it fell
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::fall(unsigned char rows, const Matrix& matrix)
+{
+	unsigned char distance = std::min(rows, getDropDistance(matrix));
+
+	if (distance == 0)
 	{
-		bool canTurn = true;
+		return 0;
+	}
 
-		for (sf::Vector2i& mino : m_Minos)
-		{
-			if (mino.x + wallKickPoint.x < 0 || mino.x + wallKickPoint.x >= COLUMNS || mino.y + wallKickPoint.y >= ROWS)
-			{
-				canTurn = false;
-				break;
-			}
+	m_Position.y += distance;
+	m_LastKick = 0;
 
-			if (mino.y + wallKickPoint.y < 0)
-			{
-				continue;
-			}
-			else if (matrix[mino.x + wallKickPoint.x][mino.y + wallKickPoint.y] > 0)
-			{
-				canTurn = false;
-				break;
-			}
-		}
+	return distance;
+}
 
-		if (canTurn)
-		{
-			m_Rotation = nextRotation;
+template <typename Rules>
+TetrominoShapes::Shape BasicTetromino<Rules>::getNextShape() const
+{
+	return m_NextShape;
+}
 
-			for (sf::Vector2i& mino : m_Minos)
-			{
-				mino.x += wallKickPoint.x;
-				mino.y += wallKickPoint.y;
-			}
+template <typename Rules>
+TetrominoShapes::Shape BasicTetromino<Rules>::getHoldingShape() const
+{
+	return m_HoldShape;
+}
 
-			return;
-		}
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getNextShapeTetromino(unsigned char x, unsigned char y)
+{
+	return getTetromino(m_NextShape, x, y);
+}
+
+template <typename Rules>
+std::array<Vector2i, 4> BasicTetromino<Rules>::getHoldMinos(unsigned char x, unsigned char y)
+{
+	if (m_IsHolding)
+		return getTetromino(m_HoldShape, x, y);
+
+	return std::array<Vector2i, 4>();
+}
+
+template <typename Rules>
+bool BasicTetromino<Rules>::isHolding() const
+{
+	return m_IsHolding;
+}
+
+/// @brief Shapes left in the current 7-bag after the next shape, bit n set for Shape n. Empty means a fresh bag comes next
+template <typename Rules>
+unsigned char BasicTetromino<Rules>::getBagMask() const
+{
+	unsigned char mask = 0;
+
+	for (unsigned char i = 0; i < m_BagSize; i++)
+	{
+		mask |= 1 << m_Bag[i];
 	}
 
-	m_Minos = currentMinos;
+	return mask;
 }
 
-void Tetromino::updateMatrix(std::vector<std::vector<unsigned char>>& matrix)
+template <typename Rules>
+int BasicTetromino<Rules>::hardDrop(Matrix& matrix)
 {
-	for (sf::Vector2i& mino : m_Minos)
+	int distance = getDropDistance(matrix);
+	m_Position.y += distance;
+
+	if (distance > 0)
 	{
-		if (mino.y < 0)
-		{
-			continue;
-		}
+		m_LastKick = 0;
+	}
 
-		matrix[mino.x][mino.y] = 1 + getShape();
+	return distance;
+}
+
+template <typename Rules>
+void BasicTetromino<Rules>::processHoldSwap(Matrix& matrix)
+{
+	if (!m_IsHolding)
+	{
+		m_HoldShape = m_Shape;
+		m_IsHolding = true;
+		reset(matrix);
+	}
+	else
+	{
+		auto tempShape = m_HoldShape;
+		m_HoldShape = m_Shape;
+		reset(tempShape, matrix);
+	}
+}
+
+/// @brief Mixes the piece, hold, bag and RNG state into a running hash
+template <typename Rules>
+unsigned long long BasicTetromino<Rules>::hash(unsigned long long hash) const
+{
+	for (const Vector2i& mino : getMinos())
+	{
+		hash = hashWord(hash, (static_cast<unsigned long long>(static_cast<unsigned int>(mino.x)) << 32) | static_cast<unsigned int>(mino.y));
 	}
+
+	unsigned long long pieces = m_Position.rotation;
+	pieces |= static_cast<unsigned long long>(m_Shape) << 8;
+	pieces |= static_cast<unsigned long long>(m_NextShape) << 16;
+	pieces |= static_cast<unsigned long long>(m_HoldShape) << 24;
+	pieces |= static_cast<unsigned long long>(m_IsHolding) << 32;
+	pieces |= static_cast<unsigned long long>(m_BagSize) << 40;
+	pieces |= static_cast<unsigned long long>(m_LastKick) << 48;
+	hash = hashWord(hash, pieces);
+	hash = hashBytes(hash, m_Bag.data(), m_Bag.size());
+	return hashWord(hash, m_Random);
 }
 
-std::vector<sf::Vector2i> Tetromino::getMinos()
+template <typename Rules>
+const std::array<Vector2i, TETROMINO_KICKS>& BasicTetromino<Rules>::getWallKickData(unsigned char nextRotation)
 {
-	return m_Minos;
+	return Rules::Rotation::getKicks(m_Shape, m_Position.rotation, nextRotation);
 }
 
-unsigned char Tetromino::getRotation()
+template <typename Rules>
+TetrominoShapes::Shape BasicTetromino<Rules>::selectRandomShape()
 {
-	return m_Rotation;
+	return Rules::Randomizer::draw(m_Bag, m_BagSize, m_Random);
 }
 
-std::vector<sf::Vector2i> Tetromino::getWallKickData(unsigned char nextRotation)
+const std::array<Vector2i, TETROMINO_KICKS>& SrsRotation::getKicks(TetrominoShapes::Shape shape, unsigned char from, unsigned char to)
 {
-	if (m_Shape == Shape::I)
+	if (shape == TetrominoShapes::Shape::I)
 	{
-		if (m_Rotation == 0)
+		if (from == 0)
 		{
-			if (nextRotation == 1)
+			if (to == 1)
 			{
-				return { { 0, 0 }, { -2, 0 }, { 1, 0 }, { -2, 1 }, { 1, -2 } };
+				return kicksI01;
 			}
-			else if (nextRotation == 3)
+			else if (to == 3)
 			{
-				return { { 0, 0 }, { -1, 0 }, { 2, 0 }, { -1, -2 }, { 2, 1 } };
+				return kicksI03;
 			}
 		}
-		else if (m_Rotation == 1)
+		else if (from == 1)
 		{
-			if (nextRotation == 0)
+			if (to == 0)
 			{
-				return { { 0, 0 }, { 2, 0 }, { -1, 0 }, { 2, -1 }, { -1, 2 } };
+				return kicksI10;
 			}
-			else if (nextRotation == 2)
+			else if (to == 2)
 			{
-				return { { 0, 0 }, { -1, 0 }, { 2, 0 }, { -1, -2 }, { 2, 1 } };
+				return kicksI03;
 			}
 		}
-		else if (m_Rotation == 2)
+		else if (from == 2)
 		{
-			if (nextRotation == 1)
+			if (to == 1)
 			{
-				return { { 0, 0 }, { 1, 0 }, { -2, 0 }, { 1, 2 }, { -2, -1 } };
+				return kicksI21;
 			}
-			else if (nextRotation == 3)
+			else if (to == 3)
 			{
-				return { { 0, 0 }, { 2, 0 }, { -1, 0 }, { 2, -1 }, { -1, 2 } };
+				return kicksI10;
 			}
 		}
-		else if (m_Rotation == 3)
+		else if (from == 3)
 		{
-			if (nextRotation == 0)
+			if (to == 0)
 			{
-				return { { 0, 0 }, { 1, 0 }, { -2, 0 }, { 1, 2 }, { -2, -1 } };
+				return kicksI21;
 			}
-			else if (nextRotation == 2)
+			else if (to == 2)
 			{
-				return { { 0, 0 }, { -2, 0 }, { 1, 0 }, { -2, 1 }, { 1, -2 } };
+				return kicksI01;
 			}
 		}
 	}
 	else
 	{
-		if (m_Rotation == 0 || m_Rotation == 2)
+		if (from == 0 || from == 2)
 		{
-			if (nextRotation == 1)
+			if (to == 1)
 			{
-				return { { 0, 0 }, { -1, 0 }, { -1, -1 }, { 0, 2 }, { -1, 2 } };
+				return kicksCW;
 			}
-			else if (nextRotation == 3)
+			else if (to == 3)
 			{
-				return { { 0, 0 }, { 1, 0 }, { 1, -1 }, { 0, 2 }, { 1, 2 } };
+				return kicksCCW;
 			}
 		}
-		else if (m_Rotation == 1)
+		else if (from == 1)
 		{
-			return { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, -2 }, { 1, -2 } };
+			return kicksFrom1;
 		}
-		else if (m_Rotation == 3)
+		else if (from == 3)
 		{
-			return { { 0, 0 }, { -1, 0 }, { -1, 1 }, { 0, -2 }, { -1, -2 } };
+			return kicksFrom3;
 		}
 	}
 
-	return { { 0, 0 } };
+	return kicksNone;
 }
 
-std::vector<sf::Vector2i> Tetromino::getGhostMinos(const std::vector<std::vector<unsigned char>>& matrix)
+const std::array<Vector2i, TETROMINO_KICKS>& ArsRotation::getKicks(TetrominoShapes::Shape shape, unsigned char, unsigned char)
 {
-	int distance = 0;
-	bool collisionFound = false;
-
-	std::vector<sf::Vector2i> ghostMinos = m_Minos;
-
-	while (!collisionFound)
-	{
-		distance++;
-
-		for (sf::Vector2i mino : m_Minos)
-		{
-			if (distance + mino.y == ROWS || (distance + mino.y > 0 && matrix[mino.x][distance + mino.y] > 0))
-			{
-				collisionFound = true;
-				break;
-			}
-		}
-	}
-
-	for (sf::Vector2i& mino : ghostMinos)
-	{
-		mino.y += distance - 1;
-	}
-
-	return ghostMinos;
-}
-
-Tetromino::Shape Tetromino::getNextShape()
-{
-	return m_NextShape;
+	return shape == TetrominoShapes::Shape::I ? kicksNone : kicksArs;
 }
 
-Tetromino::Shape Tetromino::getHoldingShape()
+const std::array<Vector2i, TETROMINO_KICKS>& ClassicRotation::getKicks(TetrominoShapes::Shape, unsigned char, unsigned char)
 {
-	return m_HoldShape;
+	return kicksNone;
 }
 
-std::vector<sf::Vector2i> Tetromino::getNextShapeTetromino(unsigned char x, unsigned char y)
+TetrominoShapes::Shape SevenBagRandomizer::draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random)
 {
-	return getTetromino(m_NextShape, x, y);
-}
-
-std::vector<sf::Vector2i> Tetromino::getHoldMinos(unsigned char x, unsigned char y)
-{
-	if (m_IsHolding)
-		return getTetromino(m_HoldShape, x, y);
-
-	return std::vector<sf::Vector2i> { { 0, 0 } };
-}
+	if (size == 0)
+	{
+		state = {
+			TetrominoShapes::Shape::I,
+			TetrominoShapes::Shape::J,
+			TetrominoShapes::Shape::L,
+			TetrominoShapes::Shape::O,
+			TetrominoShapes::Shape::S,
+			TetrominoShapes::Shape::T,
+			TetrominoShapes::Shape::Z,
+		};
+		size = state.size();
+	}
 
-bool Tetromino::isHolding()
-{
-	return m_IsHolding;
+	// Draw a random shape from the bag and fill its slot with the last one
+	unsigned char index = nextRandom(random) % size;
+	TetrominoShapes::Shape toReturn = state[index];
+	state[index] = state[--size];
+	return toReturn;
 }
 
-int Tetromino::hardDrop(std::vector<std::vector<unsigned char>>& matrix)
+TetrominoShapes::Shape TgmRandomizer::draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random)
 {
-	std::vector<sf::Vector2i> ghostMinos = getGhostMinos(matrix);
-
-	int distance = ghostMinos[0].y - m_Minos[0].y;
-
-	m_Minos = getGhostMinos(matrix);
+	TetrominoShapes::Shape shape;
 
-	return distance;
-}
-
-void Tetromino::processHoldSwap(std::vector<std::vector<unsigned char>>& matrix)
-{
-	if (!m_IsHolding)
+	if (size == 0)
 	{
-		m_HoldShape = m_Shape;
-		m_IsHolding = true;
-		reset(matrix);
+		// The first piece is never an S, Z or O
+		const TetrominoShapes::Shape firstShapes[] = { TetrominoShapes::Shape::I, TetrominoShapes::Shape::J, TetrominoShapes::Shape::L, TetrominoShapes::Shape::T };
+		shape = firstShapes[nextRandom(random) % 4];
+		state.fill(TetrominoShapes::Shape::Z);
+		size = TGM_HISTORY;
 	}
 	else
 	{
-		auto tempShape = m_HoldShape;
-		m_HoldShape = m_Shape;
-		reset(tempShape, matrix);
+		for (unsigned char roll = 0; roll < TGM_ROLLS; roll++)
+		{
+			shape = static_cast<TetrominoShapes::Shape>(nextRandom(random) % 7);
+
+			if (std::find(state.begin(), state.begin() + TGM_HISTORY, shape) == state.begin() + TGM_HISTORY)
+			{
+				break;
+			}
+		}
 	}
+
+	std::move_backward(state.begin(), state.begin() + TGM_HISTORY - 1, state.begin() + TGM_HISTORY);
+	state[0] = shape;
+	return shape;
 }
 
-Tetromino::Shape Tetromino::selectRandomShape()
+TetrominoShapes::Shape NesRandomizer::draw(std::array<TetrominoShapes::Shape, 7>& state, unsigned char& size, unsigned long long& random)
 {
-	if (availableShapes.size() == 0)
+	// One of eight is a reroll, as is repeating the last shape
+	unsigned char roll = nextRandom(random) % 8;
+
+	if (roll == 7 || (size > 0 && roll == state[0]))
 	{
-		availableShapes.insert(availableShapes.end(),
-			{
-				Tetromino::Shape::I,
-				Tetromino::Shape::J,
-				Tetromino::Shape::L,
-				Tetromino::Shape::O,
-				Tetromino::Shape::S,
-				Tetromino::Shape::T,
-				Tetromino::Shape::Z,
-			});
+		roll = nextRandom(random) % 7;
 	}
 
-	std::shuffle(std::begin(availableShapes), std::end(availableShapes), m_Random);
+	state[0] = static_cast<TetrominoShapes::Shape>(roll);
+	size = 1;
+	return state[0];
+}
 
-	Tetromino::Shape toReturn = availableShapes.back();
-	availableShapes.pop_back();
-	return toReturn;
-}
\ No newline at end of file
+template class BasicTetromino<GuidelineRules>;
+template class BasicTetromino<ClassicRules>;
+template class BasicTetromino<TgmRules>;
+template class BasicTetromino<FourWideRules>;
+template class BasicTetromino<SixteenWideRules>;
+template class BasicTetromino<TallRules>;
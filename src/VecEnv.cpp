@@ -0,0 +1,374 @@
+#include "Headers/VecEnv.hpp"
+#include "Headers/Hash.hpp"
+#include "Headers/Heuristic.hpp"
+
+namespace
+{
+// A piece in one rotation as row masks relative to its top left corner
+struct PieceMask
+{
+	std::array<StandardBoard::Row, 4> rows;
+	unsigned char width;
+	unsigned char height;
+};
+
+// Pieces spawn with minos no higher than the row above their spawn row, spawn masks start there
+constexpr unsigned char SPAWN_TOP = StandardBoard::SPAWN_Y - 1;
+
+struct PieceMasks
+{
+	std::array<std::array<PieceMask, 4>, 7> rotations;
+	// Spawn position masks against the board rows from SPAWN_TOP down
+	std::array<std::array<StandardBoard::Row, 4>, 7> spawnRows;
+};
+
+/// @brief Shapes are taken from Tetromino itself so the two can't drift apart
+const PieceMasks& getPieceMasks()
+{
+	static const PieceMasks masks = [] {
+		PieceMasks result {};
+		Matrix empty {};
+		Tetromino tetromino(1);
+
+		for (unsigned char shape = 0; shape < 7; shape++)
+		{
+			tetromino.reset(static_cast<Tetromino::Shape>(shape), empty);
+
+			for (const Vector2i& mino : tetromino.getMinos())
+			{
+				result.spawnRows[shape][mino.y - SPAWN_TOP] |= 1 << mino.x;
+			}
+
+			// Rotate away from the top edge so no rotation needs a kick
+			tetromino.moveDown(empty);
+			tetromino.moveDown(empty);
+
+			for (unsigned char rotation = 0; rotation < 4; rotation++)
+			{
+				std::array<Vector2i, 4> minos = tetromino.getMinos();
+				int minX = COLUMNS, minY = ROWS, maxX = 0, maxY = 0;
+
+				for (const Vector2i& mino : minos)
+				{
+					minX = std::min(minX, mino.x);
+					minY = std::min(minY, mino.y);
+					maxX = std::max(maxX, mino.x);
+					maxY = std::max(maxY, mino.y);
+				}
+
+				PieceMask& mask = result.rotations[shape][rotation];
+				mask.width = maxX - minX + 1;
+				mask.height = maxY - minY + 1;
+
+				for (const Vector2i& mino : minos)
+				{
+					mask.rows[mino.y - minY] |= 1 << (mino.x - minX);
+				}
+
+				tetromino.rotate(true, empty);
+			}
+		}
+
+		return result;
+	}();
+
+	return masks;
+}
+
+bool fits(const std::array<StandardBoard::Row, ROWS>& board, const PieceMask& mask, unsigned char x, unsigned char y)
+{
+	if (x + mask.width > COLUMNS || y + mask.height > ROWS)
+	{
+		return false;
+	}
+
+	for (unsigned char i = 0; i < mask.height; i++)
+	{
+		if (board[y + i] & (mask.rows[i] << x))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+}
+
+VecEnv::VecEnv(unsigned int count, unsigned long long seed, unsigned int maxPieces) :
+	m_Count(count),
+	m_MaxPieces(maxPieces),
+	m_SeedStream(seed),
+	m_Boards(count),
+	m_Queues(count),
+	m_Holds(count),
+	m_Scores(count),
+	m_Lines(count),
+	m_Pieces(count)
+{
+	m_Randomizers.reserve(count);
+
+	for (unsigned int env = 0; env < count; env++)
+	{
+		m_Randomizers.emplace_back(0);
+		resetEnv(env);
+	}
+}
+
+/// @brief Writes the current observation of every game, observations must hold getCount() * VECENV_OBSERVATION_SIZE bytes
+void VecEnv::reset(unsigned char* observations)
+{
+	for (unsigned int env = 0; env < m_Count; env++)
+	{
+		writeObservation(env, observations + env * VECENV_OBSERVATION_SIZE);
+	}
+}
+
+/// @brief Plays one placement in every game. Illegal actions fall back to the first legal one. A game that ends
+/// reports done and is restarted from the next seed, so its observation is already the start of the new game
+void VecEnv::step(const unsigned char* actions, unsigned char* observations, float* rewards, unsigned char* dones)
+{
+	for (unsigned int env = 0; env < m_Count; env++)
+	{
+		dones[env] = stepEnv(env, actions[env], observations + env * VECENV_OBSERVATION_SIZE, rewards[env]);
+	}
+}
+
+/// @brief Steps a single game and writes the result in place, such as straight into a shared memory slot
+void VecEnv::step(unsigned int env, unsigned char action, Transition& transition)
+{
+	transition.env = env;
+	transition.action = action;
+	transition.done = stepEnv(env, action, transition.observation, transition.reward);
+}
+
+unsigned int VecEnv::getCount() const
+{
+	return m_Count;
+}
+
+int VecEnv::getScore(unsigned int env) const
+{
+	return m_Scores[env];
+}
+
+int VecEnv::getLinesCleared(unsigned int env) const
+{
+	return m_Lines[env];
+}
+
+/// @brief Board of one game in the layout the renderer and GameSession use, placed minos are all 1
+Matrix VecEnv::getMatrix(unsigned int env) const
+{
+	Matrix matrix {};
+
+	for (unsigned char y = 0; y < ROWS; y++)
+	{
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			matrix[x][y] = (m_Boards[env][y] >> x) & 1;
+		}
+	}
+
+	return matrix;
+}
+
+/// @brief Plays one action, restarting the game if it ends. Returns whether it ended
+bool VecEnv::stepEnv(unsigned int env, unsigned char action, unsigned char* observation, float& reward)
+{
+	int gained = place(env, action);
+	bool done = gained < 0 || !canSpawn(env) || getFirstLegalAction(env) == VECENV_ACTIONS
+		|| (m_MaxPieces > 0 && m_Pieces[env] >= m_MaxPieces);
+
+	reward = std::max(gained, 0);
+
+	if (done)
+	{
+		resetEnv(env);
+	}
+
+	writeObservation(env, observation);
+
+	return done;
+}
+
+/// @brief Starts a new game seeded from the stream, the stream is a splitmix sequence so restarts never repeat
+void VecEnv::resetEnv(unsigned int env)
+{
+	m_SeedStream += 0x9E3779B97F4A7C15ULL;
+	m_Randomizers[env] = Tetromino(finalizeHash(m_SeedStream));
+
+	m_Boards[env] = {};
+	m_Holds[env] = 7;
+	m_Scores[env] = 0;
+	m_Lines[env] = 0;
+	m_Pieces[env] = 0;
+
+	m_Queues[env][0] = m_Randomizers[env].getShape();
+	m_Queues[env][1] = m_Randomizers[env].getNextShape();
+
+	for (unsigned char i = 2; i <= VECENV_PREVIEWS; i++)
+	{
+		m_Queues[env][i] = drawShape(env);
+	}
+}
+
+Tetromino::Shape VecEnv::drawShape(unsigned int env)
+{
+	static const Matrix empty {};
+
+	m_Randomizers[env].reset(empty);
+
+	return m_Randomizers[env].getNextShape();
+}
+
+/// @brief Hard drops the piece chosen by the action and clears lines. Returns the score gained, or -1 if no action was legal
+int VecEnv::place(unsigned int env, unsigned char action)
+{
+	const PieceMasks& masks = getPieceMasks();
+	std::array<StandardBoard::Row, ROWS>& board = m_Boards[env];
+	std::array<Tetromino::Shape, VECENV_PREVIEWS + 1>& queue = m_Queues[env];
+
+	Tetromino::Shape held = m_Holds[env] == 7 ? queue[1] : static_cast<Tetromino::Shape>(m_Holds[env]);
+	Tetromino::Shape shape = action >= 4 * COLUMNS ? held : queue[0];
+
+	if (action >= VECENV_ACTIONS || !fits(board, masks.rotations[shape][action / COLUMNS % 4], action % COLUMNS, 0))
+	{
+		action = getFirstLegalAction(env);
+		shape = queue[0];
+
+		if (action == VECENV_ACTIONS)
+		{
+			return -1;
+		}
+	}
+
+	// Holding into an empty slot plays the next piece, which takes two pieces off the queue
+	bool advanceTwice = action >= 4 * COLUMNS && m_Holds[env] == 7;
+
+	if (action >= 4 * COLUMNS)
+	{
+		m_Holds[env] = queue[0];
+	}
+
+	const PieceMask& mask = masks.rotations[shape][action / COLUMNS % 4];
+	unsigned char x = action % COLUMNS;
+	unsigned char y = 0;
+
+	while (fits(board, mask, x, y + 1))
+	{
+		y++;
+	}
+
+	for (unsigned char i = 0; i < mask.height; i++)
+	{
+		board[y + i] |= mask.rows[i] << x;
+	}
+
+	// Collapse full rows from the bottom up
+	unsigned char linesCleared = 0;
+
+	for (int from = ROWS - 1, to = ROWS - 1; to >= 0; from--)
+	{
+		if (from >= 0 && board[from] == StandardBoard::FULL_ROW)
+		{
+			linesCleared++;
+			continue;
+		}
+
+		board[to--] = from >= 0 ? board[from] : 0;
+	}
+
+	int reward = Heuristic::getLineClearScore(linesCleared, m_Lines[env] / 10 + 1);
+
+	m_Lines[env] += linesCleared;
+	m_Scores[env] += reward;
+	m_Pieces[env]++;
+
+	for (unsigned char advance = 0; advance < (advanceTwice ? 2 : 1); advance++)
+	{
+		std::move(queue.begin() + 1, queue.end(), queue.begin());
+		queue[VECENV_PREVIEWS] = drawShape(env);
+	}
+
+	return reward;
+}
+
+/// @brief First action whose piece fits at the top of the board, VECENV_ACTIONS if none does
+unsigned char VecEnv::getFirstLegalAction(unsigned int env) const
+{
+	const PieceMasks& masks = getPieceMasks();
+
+	for (unsigned char rotation = 0; rotation < 4; rotation++)
+	{
+		const PieceMask& mask = masks.rotations[m_Queues[env][0]][rotation];
+
+		for (unsigned char x = 0; x + mask.width <= COLUMNS; x++)
+		{
+			if (fits(m_Boards[env], mask, x, 0))
+			{
+				return rotation * COLUMNS + x;
+			}
+		}
+	}
+
+	return VECENV_ACTIONS;
+}
+
+/// @brief Same block out rule as Tetromino::reset, the new piece must not overlap the stack where it spawns
+bool VecEnv::canSpawn(unsigned int env) const
+{
+	const std::array<StandardBoard::Row, 4>& spawn = getPieceMasks().spawnRows[m_Queues[env][0]];
+
+	for (unsigned char y = 0; y < spawn.size(); y++)
+	{
+		if (m_Boards[env][SPAWN_TOP + y] & spawn[y])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void VecEnv::writeObservation(unsigned int env, unsigned char* observation) const
+{
+	const PieceMasks& masks = getPieceMasks();
+	const std::array<StandardBoard::Row, ROWS>& board = m_Boards[env];
+	const std::array<Tetromino::Shape, VECENV_PREVIEWS + 1>& queue = m_Queues[env];
+
+	std::memset(observation, 0, VECENV_OBSERVATION_SIZE);
+
+	for (unsigned char y = 0; y < ROWS; y++)
+	{
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			observation[VECENV_BOARD_OFFSET + y * COLUMNS + x] = (board[y] >> x) & 1;
+		}
+	}
+
+	observation[VECENV_PIECE_OFFSET + queue[0]] = 1;
+	observation[VECENV_HOLD_OFFSET + m_Holds[env]] = 1;
+
+	for (unsigned char i = 0; i < VECENV_PREVIEWS; i++)
+	{
+		observation[VECENV_PREVIEW_OFFSET + i * 7 + queue[i + 1]] = 1;
+	}
+
+	// The hold half of the mask depends on which piece hold would bring in
+	Tetromino::Shape held = m_Holds[env] == 7 ? queue[1] : static_cast<Tetromino::Shape>(m_Holds[env]);
+
+	for (unsigned char hold = 0; hold < 2; hold++)
+	{
+		Tetromino::Shape shape = hold ? held : queue[0];
+
+		for (unsigned char rotation = 0; rotation < 4; rotation++)
+		{
+			const PieceMask& mask = masks.rotations[shape][rotation];
+
+			for (unsigned char x = 0; x + mask.width <= COLUMNS; x++)
+			{
+				observation[VECENV_MASK_OFFSET + hold * 4 * COLUMNS + rotation * COLUMNS + x] = fits(board, mask, x, 0);
+			}
+		}
+	}
+}
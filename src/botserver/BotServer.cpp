@@ -0,0 +1,337 @@
+#include "BotServer.hpp"
+#include "Tbp.hpp"
+
+BotServer::BotServer(unsigned char previews) :
+	m_Previews(previews)
+{
+}
+
+BotServer::~BotServer()
+{
+	if (m_ToBot != nullptr)
+	{
+		m_Message.str("");
+		m_Message << "{\"type\":\"quit\"}";
+		send();
+		std::fclose(m_ToBot);
+	}
+
+	if (m_FromBot != nullptr)
+	{
+		std::fclose(m_FromBot);
+	}
+
+	if (m_Process > 0)
+	{
+		waitpid(m_Process, nullptr, 0);
+	}
+}
+
+/// @brief Starts the bot through the shell and waits for it to accept the rules
+bool BotServer::launch(const std::string& command)
+{
+	int toBot[2];
+	int fromBot[2];
+
+	if (pipe(toBot) != 0 || pipe(fromBot) != 0)
+	{
+		std::cerr << "Could not create pipes for the bot" << std::endl;
+		return false;
+	}
+
+	m_Process = fork();
+
+	if (m_Process < 0)
+	{
+		std::cerr << "Could not start the bot" << std::endl;
+		return false;
+	}
+
+	if (m_Process == 0)
+	{
+		dup2(toBot[0], STDIN_FILENO);
+		dup2(fromBot[1], STDOUT_FILENO);
+		close(toBot[0]);
+		close(toBot[1]);
+		close(fromBot[0]);
+		close(fromBot[1]);
+
+		execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+		_exit(127);
+	}
+
+	close(toBot[0]);
+	close(fromBot[1]);
+	m_ToBot = fdopen(toBot[1], "w");
+	m_FromBot = fdopen(fromBot[0], "r");
+
+	// A bot that exits early shouldn't take the server down with it
+	signal(SIGPIPE, SIG_IGN);
+
+	JsonValue message;
+
+	if (!receive(message) || !message["type"].is("info"))
+	{
+		std::cerr << "Bot did not introduce itself" << std::endl;
+		return false;
+	}
+
+	m_BotName = message["name"].string + " " + message["version"].string;
+
+	m_Message.str("");
+	m_Message << "{\"type\":\"rules\",\"randomizer\":{\"type\":\"seven_bag\"}}";
+
+	if (!send() || !receive(message) || !message["type"].is("ready"))
+	{
+		std::cerr << "Bot rejected the rules: " << message["reason"].string << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+/// @brief Plays one game until the bot tops out, gives up or reaches the piece limit
+bool BotServer::playGame(unsigned long long seed, unsigned int maxPieces)
+{
+	GameSession session(seed);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	m_Message.str("");
+	m_Message << "{\"type\":\"start\",\"hold\":null,\"queue\":[";
+	writeQueue(session, 0, m_Previews);
+	m_Message << "],\"randomizer\":{\"type\":\"seven_bag\",\"bag_state\":[";
+	writeBagState(session);
+	m_Message << "]},\"combo\":0,\"back_to_back\":false,\"board\":";
+	tbp::writeBoard(m_Message, session.matrix);
+	m_Message << '}';
+
+	if (!send())
+	{
+		return false;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	JsonValue message;
+	bool alive = true;
+
+	for (unsigned int piece = 0; piece < maxPieces && alive; piece++)
+	{
+		m_Message.str("");
+		m_Message << "{\"type\":\"suggest\"}";
+
+		auto requested = std::chrono::steady_clock::now();
+
+		if (!send() || !receive(message))
+		{
+			return false;
+		}
+
+		m_RoundTrips.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - requested).count());
+
+		if (!message["type"].is("suggestion") || message["moves"].items.empty())
+		{
+			break;
+		}
+
+		// The bot's moves are in order of preference, play the first legal one
+		int played = -1;
+		bool holdWasEmpty = !session.tetromino.isHolding();
+		int linesBefore = session.totalLinesCleared;
+
+		for (std::size_t i = 0; i < message["moves"].items.size() && played < 0; i++)
+		{
+			if (tryMove(session, message["moves"].items[i]))
+			{
+				played = i;
+			}
+			else
+			{
+				m_InvalidMoves++;
+			}
+		}
+
+		if (played < 0)
+		{
+			break;
+		}
+
+		alive = session.currentGameState != GameState::GAME_OVER;
+		m_Pieces++;
+		m_Lines += session.totalLinesCleared - linesBefore;
+
+		m_Message.str("");
+		m_Message << "{\"type\":\"play\",\"move\":";
+		message["moves"].items[played].write(m_Message);
+		m_Message << '}';
+
+		if (!send())
+		{
+			return false;
+		}
+
+		// Holding into an empty slot takes two pieces off the queue
+		unsigned char consumed = holdWasEmpty && session.tetromino.isHolding() ? 2 : 1;
+
+		for (unsigned char i = 0; i < consumed && alive; i++)
+		{
+			m_Message.str("");
+			m_Message << "{\"type\":\"new_piece\",\"piece\":";
+			writeQueue(session, m_Previews + 1 - consumed + i, m_Previews + 1 - consumed + i);
+			m_Message << '}';
+
+			if (!send())
+			{
+				return false;
+			}
+		}
+	}
+
+	m_PlayTime += std::chrono::steady_clock::now() - start;
+	m_Games++;
+
+	m_Message.str("");
+	m_Message << "{\"type\":\"stop\"}";
+
+	return send();
+}
+
+void BotServer::report(std::ostream& out)
+{
+	out << "Bot: " << m_BotName << '\n'
+		<< "Games: " << m_Games << ", pieces: " << m_Pieces << ", lines: " << m_Lines << ", invalid moves: " << m_InvalidMoves << '\n';
+
+	if (m_RoundTrips.empty())
+	{
+		return;
+	}
+
+	double seconds = std::chrono::duration<double>(m_PlayTime).count();
+	std::sort(m_RoundTrips.begin(), m_RoundTrips.end());
+
+	auto percentile = [this](double p) {
+		return m_RoundTrips[std::min<std::size_t>(m_RoundTrips.size() - 1, m_RoundTrips.size() * p)];
+	};
+
+	out << std::fixed << std::setprecision(1)
+		<< "Throughput: " << m_Pieces / seconds << " pieces/s\n"
+		<< "Suggest round trip (us): p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+		<< ", p99 " << percentile(0.99) << ", max " << m_RoundTrips.back() << std::endl;
+}
+
+bool BotServer::send()
+{
+	m_Message << '\n';
+	const std::string& text = m_Message.str();
+
+	return std::fwrite(text.data(), 1, text.size(), m_ToBot) == text.size() && std::fflush(m_ToBot) == 0;
+}
+
+/// @brief Reads the next message, skipping lines that aren't JSON objects
+bool BotServer::receive(JsonValue& message)
+{
+	char* buffer = nullptr;
+	std::size_t capacity = 0;
+
+	while (getline(&buffer, &capacity, m_FromBot) > 0)
+	{
+		m_Line = buffer;
+
+		if (JsonValue::parse(m_Line, message) && message.type == JsonValue::Type::OBJECT)
+		{
+			std::free(buffer);
+			return true;
+		}
+	}
+
+	std::free(buffer);
+	std::cerr << "Bot closed its output" << std::endl;
+
+	return false;
+}
+
+/// @brief Applies a bot move if the engine could reach it, otherwise leaves the session untouched
+bool BotServer::tryMove(GameSession& session, const JsonValue& move)
+{
+	Tetromino::Shape shape;
+	std::array<Vector2i, 4> minos;
+
+	if (!tbp::getLocationMinos(move["location"], shape, minos))
+	{
+		return false;
+	}
+
+	GameSession snapshot;
+	session.save(snapshot);
+
+	if (shape != session.tetromino.getShape() && (!session.hold() || shape != session.tetromino.getShape()))
+	{
+		session.restore(snapshot);
+		return false;
+	}
+
+	m_Generator.generate(session.matrix, session.tetromino);
+	int index = m_Generator.find(minos);
+
+	if (index < 0)
+	{
+		session.restore(snapshot);
+		return false;
+	}
+
+	session.place(m_Generator.getPlacement(index));
+
+	return true;
+}
+
+/// @brief Writes the shapes left in the current bag after the last piece of the queue
+void BotServer::writeBagState(const GameSession& session)
+{
+	static const Matrix empty {};
+	Tetromino preview = session.tetromino;
+
+	for (unsigned char i = 1; i < m_Previews; i++)
+	{
+		preview.reset(empty);
+	}
+
+	unsigned char mask = preview.getBagMask();
+
+	if (m_Previews == 0)
+	{
+		// The queue stops before the next shape, so it is still in the bag
+		mask |= 1 << preview.getNextShape();
+	}
+
+	bool first = true;
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		if (mask & (1 << shape))
+		{
+			m_Message << (first ? "\"" : ",\"") << tbp::getPieceName(static_cast<Tetromino::Shape>(shape)) << '"';
+			first = false;
+		}
+	}
+}
+
+/// @brief Writes TBP piece names from the queue, position 0 being the current piece and the rest previews
+void BotServer::writeQueue(const GameSession& session, unsigned char first, unsigned char last)
+{
+	static const Matrix empty {};
+	Tetromino preview = session.tetromino;
+
+	for (unsigned char i = 0; i <= last; i++)
+	{
+		Tetromino::Shape shape = i == 0 ? preview.getShape() : preview.getNextShape();
+
+		if (i >= first)
+		{
+			m_Message << (i > first ? ",\"" : "\"") << tbp::getPieceName(shape) << '"';
+		}
+
+		if (i > 0)
+		{
+			preview.reset(empty);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+#include "Json.hpp"
+
+constexpr unsigned char MAX_PREVIEWS = 16;
+
+/// @brief TBP frontend. Runs a bot as a child process talking over its stdin and stdout, plays games with
+/// this engine's rules, checks that every move the bot plays is reachable and measures how fast it answers
+class BotServer
+{
+public:
+	explicit BotServer(unsigned char previews);
+	~BotServer();
+
+	bool launch(const std::string& command);
+	bool playGame(unsigned long long seed, unsigned int maxPieces);
+	void report(std::ostream& out);
+
+protected:
+	pid_t m_Process = -1;
+	FILE* m_ToBot = nullptr;
+	FILE* m_FromBot = nullptr;
+	std::string m_Line;
+	std::ostringstream m_Message;
+
+	unsigned char m_Previews;
+	std::string m_BotName;
+	MoveGenerator m_Generator;
+
+	// Stats over every game played
+	std::vector<double> m_RoundTrips;
+	std::chrono::steady_clock::duration m_PlayTime {};
+	unsigned int m_Games = 0;
+	unsigned int m_Pieces = 0;
+	unsigned int m_InvalidMoves = 0;
+	unsigned long long m_Lines = 0;
+
+	bool send();
+	bool receive(JsonValue& message);
+	bool tryMove(GameSession& session, const JsonValue& move);
+	void writeQueue(const GameSession& session, unsigned char first, unsigned char last);
+	void writeBagState(const GameSession& session);
+};
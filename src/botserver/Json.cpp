@@ -0,0 +1,337 @@
+#include "Json.hpp"
+
+namespace
+{
+void skipSpace(const std::string& text, std::size_t& i)
+{
+	while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i])))
+	{
+		i++;
+	}
+}
+
+bool parseString(const std::string& text, std::size_t& i, std::string& out)
+{
+	if (text[i] != '"')
+	{
+		return false;
+	}
+
+	i++;
+	out.clear();
+
+	while (i < text.size() && text[i] != '"')
+	{
+		char c = text[i++];
+
+		if (c != '\\')
+		{
+			out += c;
+			continue;
+		}
+
+		if (i >= text.size())
+		{
+			return false;
+		}
+
+		c = text[i++];
+
+		switch (c)
+		{
+			case 'n':
+				out += '\n';
+				break;
+			case 't':
+				out += '\t';
+				break;
+			case 'r':
+				out += '\r';
+				break;
+			case 'b':
+				out += '\b';
+				break;
+			case 'f':
+				out += '\f';
+				break;
+			case 'u':
+			{
+				if (i + 4 > text.size())
+				{
+					return false;
+				}
+
+				// Only used for names and reasons, anything outside ASCII is replaced
+				unsigned long code = std::strtoul(text.substr(i, 4).c_str(), nullptr, 16);
+				out += code < 0x80 ? static_cast<char>(code) : '?';
+				i += 4;
+				break;
+			}
+			default:
+				out += c;
+				break;
+		}
+	}
+
+	if (i >= text.size())
+	{
+		return false;
+	}
+
+	i++;
+	return true;
+}
+
+bool parseValue(const std::string& text, std::size_t& i, JsonValue& value)
+{
+	skipSpace(text, i);
+
+	if (i >= text.size())
+	{
+		return false;
+	}
+
+	value = JsonValue();
+	char c = text[i];
+
+	if (c == '{')
+	{
+		value.type = JsonValue::Type::OBJECT;
+		i++;
+		skipSpace(text, i);
+
+		if (i < text.size() && text[i] == '}')
+		{
+			i++;
+			return true;
+		}
+
+		while (i < text.size())
+		{
+			std::pair<std::string, JsonValue> member;
+			skipSpace(text, i);
+
+			if (i >= text.size() || !parseString(text, i, member.first))
+			{
+				return false;
+			}
+
+			skipSpace(text, i);
+
+			if (i >= text.size() || text[i++] != ':' || !parseValue(text, i, member.second))
+			{
+				return false;
+			}
+
+			value.members.push_back(std::move(member));
+			skipSpace(text, i);
+
+			if (i < text.size() && text[i] == ',')
+			{
+				i++;
+			}
+			else if (i < text.size() && text[i] == '}')
+			{
+				i++;
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	if (c == '[')
+	{
+		value.type = JsonValue::Type::ARRAY;
+		i++;
+		skipSpace(text, i);
+
+		if (i < text.size() && text[i] == ']')
+		{
+			i++;
+			return true;
+		}
+
+		while (i < text.size())
+		{
+			value.items.emplace_back();
+
+			if (!parseValue(text, i, value.items.back()))
+			{
+				return false;
+			}
+
+			skipSpace(text, i);
+
+			if (i < text.size() && text[i] == ',')
+			{
+				i++;
+			}
+			else if (i < text.size() && text[i] == ']')
+			{
+				i++;
+				return true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return false;
+	}
+
+	if (c == '"')
+	{
+		value.type = JsonValue::Type::STRING;
+		return parseString(text, i, value.string);
+	}
+
+	if (text.compare(i, 4, "true") == 0 || text.compare(i, 5, "false") == 0)
+	{
+		value.type = JsonValue::Type::BOOLEAN;
+		value.boolean = c == 't';
+		i += value.boolean ? 4 : 5;
+		return true;
+	}
+
+	if (text.compare(i, 4, "null") == 0)
+	{
+		i += 4;
+		return true;
+	}
+
+	char* end = nullptr;
+	value.number = std::strtod(text.c_str() + i, &end);
+
+	if (end == text.c_str() + i)
+	{
+		return false;
+	}
+
+	value.type = JsonValue::Type::NUMBER;
+	i = end - text.c_str();
+
+	return true;
+}
+}
+
+/// @brief Parses one complete JSON document, returns false on malformed input
+bool JsonValue::parse(const std::string& text, JsonValue& value)
+{
+	std::size_t i = 0;
+
+	if (!parseValue(text, i, value))
+	{
+		return false;
+	}
+
+	skipSpace(text, i);
+
+	return i == text.size();
+}
+
+/// @brief Member lookup that yields null for missing keys and non-objects
+const JsonValue& JsonValue::operator[](const std::string& key) const
+{
+	static const JsonValue null;
+
+	for (const std::pair<std::string, JsonValue>& member : members)
+	{
+		if (member.first == key)
+		{
+			return member.second;
+		}
+	}
+
+	return null;
+}
+
+bool JsonValue::is(const std::string& text) const
+{
+	return type == Type::STRING && string == text;
+}
+
+void JsonValue::write(std::ostream& out) const
+{
+	switch (type)
+	{
+		case Type::NUL:
+			out << "null";
+			break;
+		case Type::BOOLEAN:
+			out << (boolean ? "true" : "false");
+			break;
+		case Type::NUMBER:
+			out << number;
+			break;
+		case Type::STRING:
+			writeString(out, string);
+			break;
+		case Type::ARRAY:
+			out << '[';
+
+			for (std::size_t i = 0; i < items.size(); i++)
+			{
+				if (i > 0)
+				{
+					out << ',';
+				}
+
+				items[i].write(out);
+			}
+
+			out << ']';
+			break;
+		case Type::OBJECT:
+			out << '{';
+
+			for (std::size_t i = 0; i < members.size(); i++)
+			{
+				if (i > 0)
+				{
+					out << ',';
+				}
+
+				writeString(out, members[i].first);
+				out << ':';
+				members[i].second.write(out);
+			}
+
+			out << '}';
+			break;
+		default:
+			break;
+	}
+}
+
+void JsonValue::writeString(std::ostream& out, const std::string& text)
+{
+	out << '"';
+
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+		{
+			out << '\\' << c;
+		}
+		else if (c == '\n')
+		{
+			out << "\\n";
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			out << ' ';
+		}
+		else
+		{
+			out << c;
+		}
+	}
+
+	out << '"';
+}
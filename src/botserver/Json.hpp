@@ -0,0 +1,30 @@
+#pragma once
+
+/// @brief Just enough JSON for the Tetris Bot Protocol: one message per line, no streaming
+struct JsonValue
+{
+	enum Type : unsigned char
+	{
+		NUL,
+		BOOLEAN,
+		NUMBER,
+		STRING,
+		ARRAY,
+		OBJECT
+	};
+
+	Type type = Type::NUL;
+	bool boolean = false;
+	double number = 0;
+	std::string string;
+	std::vector<JsonValue> items;
+	std::vector<std::pair<std::string, JsonValue>> members;
+
+	static bool parse(const std::string& text, JsonValue& value);
+
+	const JsonValue& operator[](const std::string& key) const;
+	bool is(const std::string& text) const;
+
+	void write(std::ostream& out) const;
+	static void writeString(std::ostream& out, const std::string& text);
+};
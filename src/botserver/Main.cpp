@@ -0,0 +1,89 @@
+#include "BotServer.hpp"
+#include "ReferenceBot.hpp"
+
+int main(int argc, char** argv)
+{
+	unsigned int games = 10;
+	unsigned int pieces = 1000;
+	unsigned long long seed = 1;
+	unsigned char previews = 5;
+	std::string command;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (!command.empty())
+		{
+			command += " " + arg;
+		}
+		else if (arg == "--bot")
+		{
+			// "--bot mcts [ms]" searches for the given time per move, "--bot expectimax [depth]" to the given depth
+			unsigned long thinkTime = 0;
+			unsigned long depth = 0;
+			std::string search = i + 1 < argc ? argv[i + 1] : "";
+
+			if (search == "mcts")
+			{
+				thinkTime = i + 2 < argc ? std::strtoul(argv[i + 2], nullptr, 10) : 100;
+			}
+			else if (search == "expectimax")
+			{
+				depth = i + 2 < argc ? std::strtoul(argv[i + 2], nullptr, 10) : 3;
+			}
+
+			ReferenceBot bot { std::chrono::milliseconds(thinkTime), static_cast<unsigned char>(std::min<unsigned long>(depth, EXPECTIMAX_MAX_DEPTH)) };
+			return bot.run(std::cin, std::cout);
+		}
+		else if (arg == "--games" && i + 1 < argc)
+		{
+			games = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--pieces" && i + 1 < argc)
+		{
+			pieces = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--seed" && i + 1 < argc)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--previews" && i + 1 < argc)
+		{
+			previews = std::min<unsigned long>(std::strtoul(argv[++i], nullptr, 10), MAX_PREVIEWS);
+		}
+		else
+		{
+			// The rest is the bot's command line
+			command = arg;
+		}
+	}
+
+	if (command.empty())
+	{
+		std::cerr << "Usage: botserver [--games n] [--pieces n] [--seed n] [--previews n] <bot command>\n"
+				  << "       botserver --bot    Runs the built-in reference bot\n"
+				  << "       botserver --bot mcts [ms]    Runs the built-in tree search bot, 100 ms per move by default\n"
+				  << "       botserver --bot expectimax [depth]    Runs the built-in bag aware expectimax bot, 3 pieces deep by default" << std::endl;
+		return 1;
+	}
+
+	BotServer server(previews);
+
+	if (!server.launch(command))
+	{
+		return 1;
+	}
+
+	for (unsigned int game = 0; game < games; game++)
+	{
+		if (!server.playGame(seed + game, pieces))
+		{
+			break;
+		}
+	}
+
+	server.report(std::cout);
+
+	return 0;
+}
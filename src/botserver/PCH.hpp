@@ -0,0 +1,41 @@
+#ifndef PRECOMPILED_HEADER_HPP
+#define PRECOMPILED_HEADER_HPP
+
+#ifndef _DEBUG
+	#ifndef NDEBUG
+		#define NDEBUG
+	#endif
+#endif // _DEBUG
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// POSIX
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Macros
+#define UNUSED(x) (void)(x)
+
+#endif // PRECOMPILED_HEADER_HPP
@@ -0,0 +1,225 @@
+#include "ReferenceBot.hpp"
+#include "Headers/Heuristic.hpp"
+#include "Tbp.hpp"
+
+ReferenceBot::ReferenceBot(std::chrono::milliseconds thinkTime, unsigned char depth) :
+	m_ThinkTime(thinkTime)
+{
+	if (m_ThinkTime.count() > 0)
+	{
+		m_Mcts.reset(new Mcts());
+	}
+	else if (depth > 0)
+	{
+		m_Expectimax.reset(new Expectimax(depth));
+	}
+}
+
+int ReferenceBot::run(std::istream& in, std::ostream& out)
+{
+	out << "{\"type\":\"info\",\"name\":\"Tetris " << (m_Mcts ? "MCTS" : m_Expectimax ? "expectimax" : "reference") << " bot\",\"version\":\"1.0\",\"author\":\"Tetris\",\"features\":[]}" << std::endl;
+
+	std::string line;
+	JsonValue message;
+
+	while (std::getline(in, line))
+	{
+		if (!JsonValue::parse(line, message))
+		{
+			continue;
+		}
+
+		const JsonValue& type = message["type"];
+
+		if (type.is("rules"))
+		{
+			out << "{\"type\":\"ready\"}" << std::endl;
+		}
+		else if (type.is("start"))
+		{
+			m_Queue.clear();
+			m_Bag = 0;
+			m_HasHold = tbp::parsePiece(message["hold"].string, m_Hold);
+			tbp::readBoard(message["board"], m_Matrix);
+
+			for (const JsonValue& piece : message["queue"].items)
+			{
+				Tetromino::Shape shape;
+
+				if (tbp::parsePiece(piece.string, shape))
+				{
+					m_Queue.push_back(shape);
+				}
+			}
+
+			for (const JsonValue& piece : message["randomizer"]["bag_state"].items)
+			{
+				Tetromino::Shape shape;
+
+				if (tbp::parsePiece(piece.string, shape))
+				{
+					m_Bag |= 1 << shape;
+				}
+			}
+		}
+		else if (type.is("suggest"))
+		{
+			suggest(out);
+		}
+		else if (type.is("play"))
+		{
+			play(message["move"]);
+		}
+		else if (type.is("new_piece"))
+		{
+			Tetromino::Shape shape;
+
+			if (tbp::parsePiece(message["piece"].string, shape))
+			{
+				m_Queue.push_back(shape);
+				m_Bag = (m_Bag == 0 ? FULL_BAG : m_Bag) & ~(1 << shape);
+			}
+		}
+		else if (type.is("quit"))
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/// @brief Suggests the best placement of the current piece or, if it scores better, of the piece hold would give
+void ReferenceBot::suggest(std::ostream& out)
+{
+	Tetromino best(1);
+	float bestScore = -1e30f;
+	bool found = false;
+
+	if (m_Mcts || m_Expectimax)
+	{
+		found = search(best);
+	}
+	else if (!m_Queue.empty())
+	{
+		found = findBest(m_Queue[0], best, bestScore);
+
+		if (m_HasHold || m_Queue.size() > 1)
+		{
+			found = findBest(m_HasHold ? m_Hold : m_Queue[1], best, bestScore) || found;
+		}
+	}
+
+	out << "{\"type\":\"suggestion\",\"moves\":[";
+
+	if (found)
+	{
+		out << "{\"location\":";
+		tbp::writeLocation(out, best);
+		out << ",\"spin\":\"none\"}";
+	}
+
+	out << "]}" << std::endl;
+}
+
+/// @brief Tracks the move the frontend chose, including the hold it implies
+void ReferenceBot::play(const JsonValue& move)
+{
+	Tetromino::Shape shape;
+	std::array<Vector2i, 4> minos;
+
+	if (m_Queue.empty() || !tbp::getLocationMinos(move["location"], shape, minos))
+	{
+		return;
+	}
+
+	if (shape != m_Queue[0])
+	{
+		Tetromino::Shape current = m_Queue[0];
+		m_Queue.pop_front();
+
+		if (!m_HasHold && !m_Queue.empty())
+		{
+			m_Queue.pop_front();
+		}
+
+		m_Hold = current;
+		m_HasHold = true;
+	}
+	else
+	{
+		m_Queue.pop_front();
+	}
+
+	Heuristic::lock(m_Matrix, minos, 1 + shape);
+}
+
+bool ReferenceBot::findBest(Tetromino::Shape shape, Tetromino& best, float& bestScore)
+{
+	Tetromino tetromino(1);
+
+	if (!tetromino.reset(shape, m_Matrix))
+	{
+		return false;
+	}
+
+	bool found = false;
+
+	unsigned short placementCount = m_Generator.generate(m_Matrix, tetromino);
+
+	for (unsigned short i = 0; i < placementCount; i++)
+	{
+		const Tetromino& placement = m_Generator.getPlacement(i);
+		Matrix matrix = m_Matrix;
+		unsigned char linesCleared = Heuristic::lock(matrix, placement.getMinos(), 1 + shape);
+
+		float score = Heuristic::evaluate(matrix, linesCleared);
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = placement;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+/// @brief Runs the tree search on what is known of the game
+bool ReferenceBot::search(Tetromino& best)
+{
+	SearchState state = getSearchState();
+	bool useHold;
+
+	if (m_Expectimax)
+	{
+		return m_Expectimax->search(state, best, useHold);
+	}
+
+	m_Mcts->setState(state);
+	m_Mcts->think(m_ThinkTime);
+
+	return m_Mcts->getBestMove(best, useHold);
+}
+
+SearchState ReferenceBot::getSearchState() const
+{
+	SearchState state {};
+	state.matrix = m_Matrix;
+	state.hold = m_HasHold ? static_cast<unsigned char>(m_Hold) : NO_HOLD;
+	state.level = 1;
+	state.queueLength = std::min<std::size_t>(m_Queue.size(), SEARCH_QUEUE);
+	std::copy(m_Queue.begin(), m_Queue.begin() + state.queueLength, state.queue.begin());
+
+	// Put the pieces that don't fit back in the bag, from the last one
+	state.bag = m_Bag;
+
+	for (std::size_t i = m_Queue.size(); i > state.queueLength; i--)
+	{
+		state.bag |= 1 << m_Queue[i - 1];
+		state.bag = state.bag == FULL_BAG ? 0 : state.bag;
+	}
+
+	return state;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Headers/Expectimax.hpp"
+#include "Headers/Mcts.hpp"
+#include "Headers/MoveGenerator.hpp"
+#include "Json.hpp"
+
+/// @brief Minimal TBP bot on stdin and stdout. Picks the placement with the best board shape one piece ahead,
+/// mostly there to benchmark the server and the protocol overhead. Given a think time it searches with Mcts instead,
+/// given a depth with Expectimax
+class ReferenceBot
+{
+public:
+	explicit ReferenceBot(std::chrono::milliseconds thinkTime = std::chrono::milliseconds(0), unsigned char depth = 0);
+
+	int run(std::istream& in, std::ostream& out);
+
+protected:
+	Matrix m_Matrix {};
+	std::deque<Tetromino::Shape> m_Queue;
+	Tetromino::Shape m_Hold = Tetromino::Shape::I;
+	bool m_HasHold = false;
+	// Shapes left in the bag after the last queued piece, bit n for Shape n
+	unsigned char m_Bag = 0;
+	MoveGenerator m_Generator;
+
+	std::chrono::milliseconds m_ThinkTime;
+	std::unique_ptr<Mcts> m_Mcts;
+	std::unique_ptr<Expectimax> m_Expectimax;
+
+	void suggest(std::ostream& out);
+	void play(const JsonValue& move);
+	bool findBest(Tetromino::Shape shape, Tetromino& best, float& bestScore);
+	bool search(Tetromino& best);
+	SearchState getSearchState() const;
+};
@@ -0,0 +1,194 @@
+#include "Tbp.hpp"
+
+namespace
+{
+// The engine's L and J are named the other way round from the guideline, TBP uses the guideline names
+const std::array<const char*, 7> pieceNames = { "I", "J", "L", "O", "S", "T", "Z" };
+const std::array<const char*, 4> orientationNames = { "north", "east", "south", "west" };
+
+// Cells around the rotation centre facing north, y up, indexed by Tetromino::Shape
+const std::array<std::array<Vector2i, 4>, 7> pieceCells = { {
+	{ Vector2i(-1, 0), Vector2i(0, 0), Vector2i(1, 0), Vector2i(2, 0) },
+	{ Vector2i(-1, 0), Vector2i(0, 0), Vector2i(1, 0), Vector2i(-1, 1) },
+	{ Vector2i(-1, 0), Vector2i(0, 0), Vector2i(1, 0), Vector2i(1, 1) },
+	{ Vector2i(0, 0), Vector2i(1, 0), Vector2i(0, 1), Vector2i(1, 1) },
+	{ Vector2i(-1, 0), Vector2i(0, 0), Vector2i(0, 1), Vector2i(1, 1) },
+	{ Vector2i(-1, 0), Vector2i(0, 0), Vector2i(1, 0), Vector2i(0, 1) },
+	{ Vector2i(-1, 1), Vector2i(0, 1), Vector2i(0, 0), Vector2i(1, 0) },
+} };
+
+Vector2i rotateCell(Vector2i cell, unsigned char orientation)
+{
+	switch (orientation)
+	{
+		case 1:
+			return Vector2i(cell.y, -cell.x);
+		case 2:
+			return Vector2i(-cell.x, -cell.y);
+		case 3:
+			return Vector2i(-cell.y, cell.x);
+		default:
+			return cell;
+	}
+}
+
+/// @brief Engine row (counted down from the top) to TBP row (counted up from the bottom) and back
+int flipRow(int y)
+{
+	return ROWS - 1 - y;
+}
+}
+
+const char* tbp::getPieceName(Tetromino::Shape shape)
+{
+	return pieceNames[shape];
+}
+
+bool tbp::parsePiece(const std::string& name, Tetromino::Shape& shape)
+{
+	for (unsigned char i = 0; i < pieceNames.size(); i++)
+	{
+		if (name == pieceNames[i])
+		{
+			shape = static_cast<Tetromino::Shape>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// @brief Cells in engine coordinates covered by a TBP piece location
+bool tbp::getLocationMinos(const JsonValue& location, Tetromino::Shape& shape, std::array<Vector2i, 4>& minos)
+{
+	if (!parsePiece(location["type"].string, shape) || location["x"].type != JsonValue::Type::NUMBER || location["y"].type != JsonValue::Type::NUMBER)
+	{
+		return false;
+	}
+
+	auto orientation = std::find(orientationNames.begin(), orientationNames.end(), location["orientation"].string);
+
+	if (orientation == orientationNames.end())
+	{
+		return false;
+	}
+
+	Vector2i centre(location["x"].number, location["y"].number);
+
+	for (unsigned char i = 0; i < 4; i++)
+	{
+		Vector2i cell = centre + rotateCell(pieceCells[shape][i], orientation - orientationNames.begin());
+		minos[i] = Vector2i(cell.x, flipRow(cell.y));
+	}
+
+	return true;
+}
+
+/// @brief Writes the TBP location object for a placement. Symmetric pieces match several orientations,
+/// the one the engine rotated to is preferred
+void tbp::writeLocation(std::ostream& out, const Tetromino& placement)
+{
+	std::array<Vector2i, 4> cells = placement.getMinos();
+
+	for (Vector2i& cell : cells)
+	{
+		cell.y = flipRow(cell.y);
+	}
+
+	Tetromino::Shape shape = placement.getShape();
+
+	for (unsigned char attempt = 0; attempt < 4; attempt++)
+	{
+		unsigned char orientation = (placement.getRotation() + attempt) % 4;
+
+		for (const Vector2i& anchor : cells)
+		{
+			Vector2i centre = anchor - rotateCell(pieceCells[shape][0], orientation);
+			bool matches = true;
+
+			for (unsigned char i = 1; i < 4 && matches; i++)
+			{
+				Vector2i cell = centre + rotateCell(pieceCells[shape][i], orientation);
+				matches = std::find(cells.begin(), cells.end(), cell) != cells.end();
+			}
+
+			if (matches)
+			{
+				out << "{\"type\":\"" << pieceNames[shape] << "\",\"orientation\":\"" << orientationNames[orientation]
+					<< "\",\"x\":" << centre.x << ",\"y\":" << centre.y << '}';
+				return;
+			}
+		}
+	}
+}
+
+/// @brief Board as TBP rows from the bottom, the rows above the engine's hidden rows are always empty
+void tbp::writeBoard(std::ostream& out, const Matrix& matrix)
+{
+	out << '[';
+
+	for (unsigned char row = 0; row < TBP_BOARD_ROWS; row++)
+	{
+		out << (row > 0 ? ",[" : "[");
+
+		for (unsigned char x = 0; x < COLUMNS; x++)
+		{
+			if (x > 0)
+			{
+				out << ',';
+			}
+
+			unsigned char cell = row < ROWS ? matrix[x][flipRow(row)] : 0;
+
+			if (cell == 0)
+			{
+				out << "null";
+			}
+			else if (cell <= pieceNames.size())
+			{
+				out << '"' << pieceNames[cell - 1] << '"';
+			}
+			else
+			{
+				out << "\"G\"";
+			}
+		}
+
+		out << ']';
+	}
+
+	out << ']';
+}
+
+/// @brief Reads a TBP board, fails if anything is stacked above the engine's hidden rows
+bool tbp::readBoard(const JsonValue& board, Matrix& matrix)
+{
+	for (std::size_t row = 0; row < board.items.size(); row++)
+	{
+		const std::vector<JsonValue>& cells = board.items[row].items;
+
+		for (std::size_t x = 0; x < cells.size() && x < COLUMNS; x++)
+		{
+			if (cells[x].type == JsonValue::Type::NUL)
+			{
+				if (row < ROWS)
+				{
+					matrix[x][flipRow(row)] = 0;
+				}
+
+				continue;
+			}
+
+			if (row >= ROWS)
+			{
+				return false;
+			}
+
+			Tetromino::Shape shape = Tetromino::Shape::I;
+			parsePiece(cells[x].string, shape);
+			matrix[x][flipRow(row)] = 1 + shape;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Headers/Global.hpp"
+#include "Headers/Rules.hpp"
+#include "Json.hpp"
+
+// Rows in a TBP board, the visible field plus the buffer above it
+constexpr unsigned char TBP_BOARD_ROWS = 40;
+
+/// @brief Conversions between the engine and the Tetris Bot Protocol (https://github.com/tetris-bot-protocol/tbp-spec).
+/// TBP counts rows up from the bottom and places pieces by their SRS rotation centre
+namespace tbp
+{
+const char* getPieceName(Tetromino::Shape shape);
+bool parsePiece(const std::string& name, Tetromino::Shape& shape);
+
+bool getLocationMinos(const JsonValue& location, Tetromino::Shape& shape, std::array<Vector2i, 4>& minos);
+void writeLocation(std::ostream& out, const Tetromino& placement);
+
+void writeBoard(std::ostream& out, const Matrix& matrix);
+bool readBoard(const JsonValue& board, Matrix& matrix);
+}
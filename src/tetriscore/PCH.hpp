@@ -0,0 +1,28 @@
+#ifndef PRECOMPILED_HEADER_HPP
+#define PRECOMPILED_HEADER_HPP
+
+#ifndef _DEBUG
+	#ifndef NDEBUG
+		#define NDEBUG
+	#endif
+#endif // _DEBUG
+
+// The engine only, no SFML
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Macros
+#define UNUSED(x) (void)(x)
+
+#endif // PRECOMPILED_HEADER_HPP
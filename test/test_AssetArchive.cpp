@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/AssetArchive.hpp"
+
+namespace
+{
+void writeFile(const util::fs::path& path, const std::string& contents)
+{
+	util::fs::create_directories(path.parent_path());
+	std::ofstream file(path, std::ios::binary);
+	file << contents;
+}
+}
+
+TEST_CASE("Asset archive packs a folder and maps it back", "[assetarchive]")
+{
+	util::fs::path directory = util::fs::temp_directory_path() / "tetris_test_content";
+	std::string path = (util::fs::temp_directory_path() / "tetris_test.pak").string();
+	util::fs::remove_all(directory);
+
+	writeFile(directory / "font.ttf", "glyphs");
+	writeFile(directory / "sounds" / "lock.wav", std::string("RIFF\0data", 9));
+	writeFile(directory / "empty.txt", "");
+
+	REQUIRE(AssetArchive::pack(directory.string(), path));
+
+	AssetArchive archive;
+	REQUIRE(archive.open(path));
+	REQUIRE(archive.getAssetCount() == 3);
+
+	AssetSpan span;
+	REQUIRE(archive.find("font.ttf", span));
+	REQUIRE(std::string(static_cast<const char*>(span.data), span.size) == "glyphs");
+	REQUIRE(reinterpret_cast<std::uintptr_t>(span.data) % 16 == 0);
+
+	REQUIRE(archive.find("sounds/lock.wav", span));
+	REQUIRE(std::string(static_cast<const char*>(span.data), span.size) == std::string("RIFF\0data", 9));
+
+	REQUIRE(archive.find("empty.txt", span));
+	REQUIRE(span.size == 0);
+
+	REQUIRE_FALSE(archive.find("lock.wav", span));
+	REQUIRE_FALSE(archive.find("sounds", span));
+	REQUIRE_FALSE(archive.find("zzz", span));
+
+	// Anything that isn't an archive is refused rather than read out of bounds
+	archive.close();
+	REQUIRE_FALSE(archive.open((directory / "font.ttf").string()));
+	REQUIRE_FALSE(archive.open((directory / "missing.pak").string()));
+
+	std::string truncated = path + ".truncated";
+	std::string contents;
+	{
+		std::ifstream in(path, std::ios::binary);
+		contents.assign((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		writeFile(truncated, contents.substr(0, 20));
+	}
+
+	REQUIRE_FALSE(archive.open(truncated));
+
+	// An entry count past the end of the file, then names out of order, the first one is "empty.txt"
+	std::string corrupt = contents;
+	corrupt.replace(5, 4, "\xFF\xFF\xFF\xFF");
+	writeFile(truncated, corrupt);
+	REQUIRE_FALSE(archive.open(truncated));
+
+	corrupt = contents;
+	corrupt[11] = 'z';
+	writeFile(truncated, corrupt);
+	REQUIRE_FALSE(archive.open(truncated));
+
+	util::fs::remove(truncated);
+	util::fs::remove(path);
+	util::fs::remove_all(directory);
+}
@@ -0,0 +1,59 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/AudioEngine.hpp"
+#include "Headers/GameSession.hpp"
+
+namespace
+{
+struct RecordingOutput : IAudioOutput
+{
+	bool loaded = false;
+	std::mutex mutex;
+	std::vector<SoundEffect> played;
+
+	bool load() final
+	{
+		loaded = true;
+		return true;
+	}
+
+	void play(SoundEffect effect) final
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		played.push_back(effect);
+	}
+};
+}
+
+TEST_CASE("Audio starts each effect within a frame of its event", "[audio]")
+{
+	GameEventBus bus;
+	RecordingOutput output;
+	AudioEngine audio(output, *bus.subscribe());
+	REQUIRE(audio.start());
+	REQUIRE(output.loaded);
+
+	GameSession session(9);
+	session.events = &bus;
+	session.step(INPUT_START);
+
+	// Events spread out like a player's, so the audio thread is asleep when most of them arrive
+	unsigned char inputs[] = { INPUT_LEFT, 0, INPUT_ROTATE_CW, 0, INPUT_RIGHT, INPUT_HARD_DROP, 0 };
+
+	for (unsigned char input : inputs)
+	{
+		session.step(input);
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	for (int i = 0; i < 100 && audio.getPlayedCount() < 4; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	audio.stop();
+
+	std::lock_guard<std::mutex> lock(output.mutex);
+	REQUIRE(output.played == std::vector<SoundEffect> { SOUND_MOVE, SOUND_ROTATE, SOUND_MOVE, SOUND_LOCK });
+	REQUIRE(audio.getMaxLatency() < FRAME_DURATION);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/Expectimax.hpp"
+#include "Headers/GameSession.hpp"
+
+TEST_CASE("Expectimax takes the line clear", "[expectimax]")
+{
+	GameSession session(7);
+
+	for (unsigned char x = 0; x < COLUMNS - 1; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+		session.matrix[x][ROWS - 2] = 1;
+	}
+
+	SearchState state = SearchState::fromSession(session);
+	state.queue[0] = Tetromino::Shape::I;
+
+	Expectimax expectimax(2);
+	Tetromino best(1);
+	bool useHold = true;
+	REQUIRE(expectimax.search(state, best, useHold));
+	REQUIRE_FALSE(useHold);
+
+	for (const Vector2i& mino : best.getMinos())
+	{
+		REQUIRE(mino.x == COLUMNS - 1);
+	}
+}
+
+TEST_CASE("Expectimax plays legal moves and reuses its table", "[expectimax]")
+{
+	GameSession session(5);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	Expectimax expectimax(3);
+	MoveGenerator generator;
+	unsigned int tableHits = 0;
+
+	for (unsigned char piece = 0; piece < 50; piece++)
+	{
+		Tetromino best(1);
+		bool useHold;
+		REQUIRE(expectimax.search(SearchState::fromSession(session), best, useHold));
+		tableHits += expectimax.getTableHits();
+
+		if (useHold)
+		{
+			REQUIRE(session.hold());
+		}
+
+		// Place the session's own piece so its hold and bag carry over
+		generator.generate(session.matrix, session.tetromino);
+		int index = generator.find(best.getMinos());
+		REQUIRE(index >= 0);
+		REQUIRE(session.place(generator.getPlacement(index)));
+	}
+
+	REQUIRE(tableHits > 0);
+	REQUIRE(session.totalLinesCleared > 0);
+}
+
+TEST_CASE("Expectimax move time", "[expectimax][!benchmark]")
+{
+	GameSession session(5);
+	Expectimax expectimax(3);
+	SearchState state = SearchState::fromSession(session);
+	Tetromino best(1);
+	bool useHold;
+
+	BENCHMARK("Search three pieces deep")
+	{
+		return expectimax.search(state, best, useHold);
+	};
+}
@@ -0,0 +1,33 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/FramePacer.hpp"
+
+TEST_CASE("Frame pacer sleeps short of the deadline and keeps jitter", "[framepacer]")
+{
+	FramePacer pacer(std::chrono::milliseconds(2));
+	FramePacer::Clock::time_point now = FramePacer::Clock::now();
+	FramePacer::Clock::time_point deadline = now + std::chrono::milliseconds(20);
+
+	pacer.sleep(deadline);
+	FramePacer::Clock::time_point woke = FramePacer::Clock::now();
+	REQUIRE(woke >= deadline - std::chrono::milliseconds(2));
+
+	// Inside the slack it returns at once so the caller can spin
+	pacer.sleep(woke + std::chrono::milliseconds(1));
+	REQUIRE(FramePacer::Clock::now() - woke < std::chrono::milliseconds(1));
+
+	for (unsigned int late = 0; late < 100; late++)
+	{
+		pacer.tick(deadline, deadline + std::chrono::microseconds(late * 10));
+	}
+
+	// Starting early counts as on time
+	pacer.tick(deadline, deadline - std::chrono::milliseconds(1));
+
+	REQUIRE(pacer.getFrameCount() == 101);
+	REQUIRE(pacer.getMaxJitter() == 990);
+	REQUIRE(pacer.getMeanJitter() == 490);
+	REQUIRE(pacer.getJitterPercentile(50) == 500);
+	REQUIRE(pacer.getJitterPercentile(100) == 1000);
+	REQUIRE(pacer.getCpuPerFrame() >= 0);
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/GameEvents.hpp"
+#include "Headers/GameSession.hpp"
+
+TEST_CASE("Game events reach every subscriber in order", "[gameevents]")
+{
+	GameEventBus bus;
+	GameEventQueue* audio = bus.subscribe();
+	GameEventQueue* stats = bus.subscribe();
+	REQUIRE(audio != nullptr);
+	REQUIRE(stats != nullptr);
+
+	GameSession session(9);
+	session.events = &bus;
+	session.step(INPUT_START);
+	session.step(INPUT_LEFT);
+	session.step(INPUT_ROTATE_CW);
+	session.step(INPUT_HOLD);
+
+	// An I hard dropped into a row with a gap exactly its size clears it
+	session.tetromino.reset(Tetromino::Shape::I, session.matrix);
+	std::array<Vector2i, 4> minos = session.tetromino.getMinos();
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+	}
+
+	for (const Vector2i& mino : minos)
+	{
+		session.matrix[mino.x][ROWS - 1] = 0;
+	}
+
+	session.step(INPUT_HARD_DROP);
+	session.step(0);
+
+	std::vector<GameEventType> expected = { EVENT_SPAWN, EVENT_MOVE, EVENT_ROTATE, EVENT_HOLD, EVENT_LOCK, EVENT_CLEAR };
+	GameEvent event;
+
+	for (GameEventType type : expected)
+	{
+		REQUIRE(audio->pop(event));
+		REQUIRE(event.type == type);
+
+		if (type == EVENT_MOVE)
+		{
+			REQUIRE(event.value == -1);
+		}
+		else if (type == EVENT_ROTATE)
+		{
+			REQUIRE(event.value == 1);
+		}
+		else if (type == EVENT_CLEAR)
+		{
+			REQUIRE(event.shape == Tetromino::Shape::I);
+			REQUIRE(event.rows == 1u << (ROWS - 1));
+		}
+	}
+
+	REQUIRE_FALSE(audio->pop(event));
+
+	for (std::size_t i = 0; i < expected.size(); i++)
+	{
+		REQUIRE(stats->pop(event));
+	}
+
+	// A consumer that falls a whole queue behind loses the newest events, the game never waits
+	for (unsigned short i = 0; i < GAME_EVENT_QUEUE_SIZE + 10; i++)
+	{
+		bus.publish({ EVENT_MOVE, 0, 1, i, {} });
+	}
+
+	REQUIRE(audio->getDropped() == 10);
+	REQUIRE(audio->pop(event));
+	REQUIRE(event.rows == 0);
+
+	// Events come out in order on another thread
+	GameEventQueue queue;
+	std::thread producer([&]()
+	{
+		for (unsigned int i = 0; i < 100000; i++)
+		{
+			while (!queue.push({ EVENT_SPAWN, 0, 0, i, {} }))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	unsigned int outOfOrder = 0;
+
+	for (unsigned int i = 0; i < 100000; i++)
+	{
+		while (!queue.pop(event))
+		{
+			std::this_thread::yield();
+		}
+
+		outOfOrder += event.rows != i;
+	}
+
+	producer.join();
+	REQUIRE(outOfOrder == 0);
+}
@@ -0,0 +1,575 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/GameEvents.hpp"
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+
+TEST_CASE("GameSession snapshot round trip", "[gamesession]")
+{
+	GameSession session;
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	GameSession snapshot;
+	session.save(snapshot);
+
+	// Play a few pieces so the board, score and bag all diverge from the snapshot
+	for (int i = 0; i < 5; i++)
+	{
+		session.score += session.tetromino.hardDrop(session.matrix) * 2;
+		session.tetromino.updateMatrix(session.matrix);
+		session.tetromino.reset(session.matrix);
+	}
+
+	REQUIRE(std::memcmp(&session, &snapshot, sizeof(GameSession)) != 0);
+
+	Tetromino::Shape expectedNext = session.tetromino.getNextShape();
+	session.restore(snapshot);
+
+	REQUIRE(std::memcmp(&session, &snapshot, sizeof(GameSession)) == 0);
+	REQUIRE(session.score == 0);
+
+	// Replaying from the snapshot draws the same pieces from the bag
+	for (int i = 0; i < 5; i++)
+	{
+		session.tetromino.hardDrop(session.matrix);
+		session.tetromino.updateMatrix(session.matrix);
+		session.tetromino.reset(session.matrix);
+	}
+
+	REQUIRE(session.tetromino.getNextShape() == expectedNext);
+}
+
+TEST_CASE("GameSession snapshot and hash", "[gamesession][!benchmark]")
+{
+	GameSession session;
+	GameSession snapshot;
+
+	BENCHMARK("save")
+	{
+		session.save(snapshot);
+		return snapshot.score;
+	};
+
+	BENCHMARK("restore")
+	{
+		session.restore(snapshot);
+		return session.score;
+	};
+
+	BENCHMARK("hash")
+	{
+		return session.hash();
+	};
+}
+
+TEST_CASE("GameSession hash follows the state", "[gamesession]")
+{
+	GameSession a(99);
+	GameSession b(99);
+
+	REQUIRE(a.hash() == b.hash());
+
+	a.step(INPUT_START);
+	b.step(INPUT_START);
+	REQUIRE(a.hash() == b.hash());
+
+	a.step(INPUT_LEFT);
+	b.step(0);
+	REQUIRE(a.hash() != b.hash());
+
+	// Same board and piece but a different RNG state must still hash differently
+	GameSession c(100);
+	REQUIRE(GameSession(99).hash() != c.hash());
+}
+
+TEST_CASE("Score table follows the guideline", "[gamesession]")
+{
+	REQUIRE(SCORE_TABLE[CLEAR_NORMAL][1][0][0] == 100);
+	REQUIRE(SCORE_TABLE[CLEAR_NORMAL][4][0][0] == 800);
+	REQUIRE(SCORE_TABLE[CLEAR_NORMAL][4][1][0] == 1200);
+	REQUIRE(SCORE_TABLE[CLEAR_NORMAL][3][1][0] == 500);
+	REQUIRE(SCORE_TABLE[CLEAR_TSPIN][0][1][3] == 400);
+	REQUIRE(SCORE_TABLE[CLEAR_TSPIN][2][1][0] == 1800);
+	REQUIRE(SCORE_TABLE[CLEAR_TSPIN_MINI][1][0][2] == 300);
+
+	// Rotation 0 points up, so its front corners are the top two
+	REQUIRE(T_SPIN_TABLE[0][0][0b1011] == CLEAR_TSPIN);
+	REQUIRE(T_SPIN_TABLE[0][0][0b1101] == CLEAR_TSPIN_MINI);
+	REQUIRE(T_SPIN_TABLE[1][0][0b1101] == CLEAR_TSPIN);
+	REQUIRE(T_SPIN_TABLE[0][2][0b1101] == CLEAR_TSPIN);
+	REQUIRE(T_SPIN_TABLE[0][2][0b0101] == CLEAR_NORMAL);
+}
+
+TEST_CASE("T-spin double scores through the table", "[gamesession]")
+{
+	GameSession session(3);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	// Two rows with a T shaped hole at x 3-5, covered at its top left
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		session.matrix[x][ROWS - 1] = x == 4 ? 0 : 1;
+		session.matrix[x][ROWS - 2] = x >= 3 && x <= 5 ? 0 : 1;
+	}
+
+	session.matrix[2][ROWS - 3] = 1;
+	session.matrix[3][ROWS - 3] = 1;
+	session.tetromino.reset(Tetromino::Shape::T, session.matrix);
+
+	MoveGenerator generator;
+	generator.generate(session.matrix, session.tetromino);
+
+	std::array<Vector2i, 4> slot = { Vector2i(3, ROWS - 2), Vector2i(4, ROWS - 2), Vector2i(5, ROWS - 2), Vector2i(4, ROWS - 1) };
+	int index = generator.find(slot);
+	REQUIRE(index >= 0);
+	REQUIRE(generator.getPlacement(index).getLastKick() > 0);
+	REQUIRE(getClearType(session.matrix, generator.getPlacement(index)) == CLEAR_TSPIN);
+
+	REQUIRE(session.place(generator.getPlacement(index)));
+	REQUIRE(session.totalLinesCleared == 2);
+	REQUIRE(session.score == 1200);
+	REQUIRE(session.backToBack);
+	REQUIRE(session.combo == 1);
+
+	// Any move after the rotation, a drop included, takes the spin away
+	Matrix empty {};
+	Tetromino tetromino(1);
+	tetromino.reset(Tetromino::Shape::T, empty);
+	tetromino.rotate(true, empty);
+	REQUIRE(tetromino.getLastKick() == 1);
+	tetromino.hardDrop(empty);
+	REQUIRE(tetromino.getLastKick() == 0);
+}
+
+TEST_CASE("Rule sets pick rotation, randomizer and scoring", "[gamesession]")
+{
+	Matrix empty {};
+
+	// A T flat against the left wall can only turn to face it with a kick
+	BasicTetromino<GuidelineRules> srs(1);
+	BasicTetromino<ClassicRules> classic(1);
+	BasicTetromino<TgmRules> ars(1);
+	srs.reset(TetrominoShapes::Shape::T, empty);
+	classic.reset(TetrominoShapes::Shape::T, empty);
+	ars.reset(TetrominoShapes::Shape::T, empty);
+
+	for (unsigned char i = 0; i < 4; i++)
+	{
+		srs.moveDown(empty);
+		classic.moveDown(empty);
+		ars.moveDown(empty);
+	}
+
+	srs.rotate(true, empty);
+	classic.rotate(true, empty);
+	ars.rotate(true, empty);
+
+	for (unsigned char i = 0; i < COLUMNS; i++)
+	{
+		srs.moveLeft(empty);
+		classic.moveLeft(empty);
+		ars.moveLeft(empty);
+	}
+
+	srs.rotate(false, empty);
+	classic.rotate(false, empty);
+	ars.rotate(false, empty);
+	REQUIRE(srs.getRotation() == 0);
+	REQUIRE(srs.getLastKick() == 2);
+	REQUIRE(classic.getRotation() == 1);
+	REQUIRE(ars.getRotation() == 0);
+	REQUIRE(ars.getLastKick() == 2);
+
+	// The 7-bag deals every shape once per bag, the TGM history opens without S, Z or O and rarely repeats
+	BasicTetromino<GuidelineRules> bag(5);
+	BasicTetromino<TgmRules> history(5);
+	REQUIRE(history.getShape() != TetrominoShapes::Shape::S);
+	REQUIRE(history.getShape() != TetrominoShapes::Shape::Z);
+	REQUIRE(history.getShape() != TetrominoShapes::Shape::O);
+
+	unsigned int repeats = 0;
+	TetrominoShapes::Shape previous = history.getShape();
+
+	for (unsigned int bagIndex = 0; bagIndex < 100; bagIndex++)
+	{
+		unsigned char seen = 0;
+
+		for (unsigned char i = 0; i < 7; i++)
+		{
+			seen |= 1 << bag.getShape();
+			bag.reset(empty);
+
+			history.reset(empty);
+			repeats += history.getShape() == previous;
+			previous = history.getShape();
+		}
+
+		REQUIRE(seen == 0x7F);
+	}
+
+	REQUIRE(repeats < 20);
+
+	// NES scoring pays 40 for a single at level 1
+	BasicGameSession<ClassicRules> session(3);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	for (unsigned char x = 0; x < COLUMNS - 1; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+	}
+
+	BasicTetromino<ClassicRules> piece = session.tetromino;
+	piece.reset(TetrominoShapes::Shape::I, session.matrix);
+	piece.rotate(true, session.matrix);
+
+	for (unsigned char i = 0; i < COLUMNS; i++)
+	{
+		piece.moveRight(session.matrix);
+	}
+
+	piece.hardDrop(session.matrix);
+	REQUIRE(session.place(piece));
+	REQUIRE(session.totalLinesCleared == 1);
+	REQUIRE(session.score == 40);
+}
+
+TEST_CASE("Rule sets pick the board size", "[gamesession]")
+{
+	static_assert(std::is_same<StandardBoard::Row, unsigned short>::value, "10 columns fit 16 bits");
+	static_assert(std::is_same<FourWideRules::Board::Row, unsigned char>::value, "4 columns fit 8 bits");
+	static_assert(std::is_same<TallRules::Board::RowMask, unsigned long long>::value, "40 rows need 64 bits");
+	static_assert(BasicGameSession<TallRules>::ROWS == 40, "The hidden rows are part of the matrix");
+
+	// One flat I fills a row of the 4 wide well
+	BasicGameSession<FourWideRules> narrow(1);
+	narrow.currentGameState = GameState::IN_PROGRESS;
+	BasicTetromino<FourWideRules> piece = narrow.tetromino;
+	piece.reset(TetrominoShapes::Shape::I, narrow.matrix);
+	REQUIRE(piece.getShiftDistance(-1, narrow.matrix) == 0);
+	REQUIRE(piece.getShiftDistance(1, narrow.matrix) == 0);
+	piece.hardDrop(narrow.matrix);
+	REQUIRE(narrow.place(piece));
+	REQUIRE(narrow.totalLinesCleared == 1);
+
+	// Pieces reach the far wall of the 16 wide board
+	BasicTetromino<SixteenWideRules>::Matrix wideEmpty {};
+	BasicTetromino<SixteenWideRules> wide(1);
+	wide.reset(TetrominoShapes::Shape::O, wideEmpty);
+	REQUIRE(wide.getShiftDistance(1, wideEmpty) == 7);
+
+	for (unsigned char i = 0; i < SixteenWideRules::Board::COLUMNS; i++)
+	{
+		wide.moveRight(wideEmpty);
+	}
+
+	REQUIRE(wide.getMinos()[0].x == SixteenWideRules::Board::COLUMNS - 1);
+
+	// The tall board spawns just under its hidden rows and marks a clear of its bottom row in the wide row mask
+	GameEventBus bus;
+	GameEventQueue* queue = bus.subscribe();
+	BasicGameSession<TallRules> tall(1);
+	tall.currentGameState = GameState::IN_PROGRESS;
+	tall.events = &bus;
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		tall.matrix[x][TallRules::Board::ROWS - 1] = x < 4 || x > 5;
+	}
+
+	BasicTetromino<TallRules> square = tall.tetromino;
+	square.reset(TetrominoShapes::Shape::O, tall.matrix);
+	REQUIRE(square.getMinos()[0] == Vector2i(COLUMNS / 2, TallRules::Board::BUFFER_ROWS + 1));
+	square.hardDrop(tall.matrix);
+	REQUIRE(tall.place(square));
+	REQUIRE(tall.totalLinesCleared == 1);
+
+	GameEvent event;
+	bool isCleared = false;
+
+	while (queue->pop(event))
+	{
+		isCleared |= event.type == EVENT_CLEAR && event.rows == 1ULL << (TallRules::Board::ROWS - 1);
+	}
+
+	REQUIRE(isCleared);
+}
+
+TEST_CASE("Hidden rows collide and top out exactly", "[gamesession]")
+{
+	Matrix matrix {};
+	matrix[4][0] = 1;
+
+	// The top hidden row collides like any other, only the space above the matrix is open
+	std::array<Vector2i, 4> minos = { { { 5, 0 }, { 6, 0 }, { 5, 1 }, { 6, 1 } } };
+	REQUIRE_FALSE(StandardBoard::fits(matrix, minos, { -1, 0 }));
+	REQUIRE(StandardBoard::fits(matrix, minos, { 1, 0 }));
+	REQUIRE(StandardBoard::fits(matrix, minos, { -1, -2 }));
+	REQUIRE_FALSE(StandardBoard::fits(matrix, minos, { 4, 0 }));
+
+	// Locking out takes a piece with no mino in the visible rows or one above the matrix
+	REQUIRE(StandardBoard::isLockedOut(minos));
+	REQUIRE_FALSE(StandardBoard::isLockedOut({ { { 5, BUFFER_ROWS - 2 }, { 6, BUFFER_ROWS - 2 }, { 5, BUFFER_ROWS - 1 }, { 6, BUFFER_ROWS } } }));
+	REQUIRE(StandardBoard::isLockedOut({ { { 5, -1 }, { 5, BUFFER_ROWS }, { 5, BUFFER_ROWS + 1 }, { 5, BUFFER_ROWS + 2 } } }));
+
+	// Every shape spawns over column 5 in the top two visible rows, so the next piece blocks out
+	GameSession session(2);
+	session.currentGameState = GameState::IN_PROGRESS;
+	session.matrix[COLUMNS / 2][BUFFER_ROWS] = 1;
+	session.matrix[COLUMNS / 2][BUFFER_ROWS + 1] = 1;
+
+	Tetromino piece = session.tetromino;
+	piece.shift(-1, COLUMNS, session.matrix);
+	piece.hardDrop(session.matrix);
+	REQUIRE_FALSE(session.place(piece));
+	REQUIRE(session.currentGameState == GameState::GAME_OVER);
+}
+
+TEST_CASE("Pieces are a shape and a packed position", "[gamesession]")
+{
+	static_assert(sizeof(Position) + sizeof(TetrominoShapes::Shape) == 4, "A piece's state fits in 4 bytes");
+
+	Matrix empty {};
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		Tetromino piece(1);
+		piece.reset(static_cast<TetrominoShapes::Shape>(shape), empty);
+		piece.moveDown(empty);
+
+		// Turning back undoes a turn, and four turns come back to the spawn footprint
+		for (unsigned char turn = 0; turn < 4; turn++)
+		{
+			std::array<Vector2i, 4> before = piece.getMinos();
+			piece.rotate(true, empty);
+			piece.rotate(false, empty);
+			REQUIRE(piece.getMinos() == before);
+			piece.rotate(true, empty);
+		}
+
+		REQUIRE(piece.getRotation() == 0);
+
+		piece.rotate(false, empty);
+		Tetromino copy(2);
+		copy.reset(static_cast<TetrominoShapes::Shape>(shape), empty);
+		copy.setPosition(piece.getPosition());
+		REQUIRE(copy.getMinos() == piece.getMinos());
+	}
+}
+
+TEST_CASE("Gravity follows the level curve up to 20G", "[gamesession]")
+{
+	for (unsigned char level = 2; level <= GUIDELINE_GRAVITY_LEVELS; level++)
+	{
+		REQUIRE(GuidelineGravity::getGravity(level) >= GuidelineGravity::getGravity(level - 1));
+	}
+
+	REQUIRE(GuidelineGravity::getGravity(1) == getFrameGravity(1000000.0 / FRAME_DURATION));
+	REQUIRE(GuidelineGravity::getGravity(GUIDELINE_GRAVITY_LEVELS) == MAX_GRAVITY);
+	REQUIRE(GuidelineGravity::getGravity(99) == MAX_GRAVITY);
+
+	// Level 1 falls a row a second
+	GameSession slow(4);
+	slow.currentGameState = GameState::IN_PROGRESS;
+	int spawnY = slow.tetromino.getMinos()[0].y;
+
+	for (unsigned char frame = 1; frame < 60; frame++)
+	{
+		slow.step(0);
+	}
+
+	REQUIRE(slow.tetromino.getMinos()[0].y == spawnY);
+	slow.step(0);
+	REQUIRE(slow.tetromino.getMinos()[0].y == spawnY + 1);
+
+	// 20G lands the piece in the frame it spawns, then it waits out the lock delay
+	GameSession fast(4);
+	fast.currentGameState = GameState::IN_PROGRESS;
+	fast.level = GUIDELINE_GRAVITY_LEVELS;
+	fast.step(0);
+	REQUIRE(fast.tetromino.getDropDistance(fast.matrix) == 0);
+	std::array<Vector2i, 4> landed = fast.tetromino.getMinos();
+
+	for (unsigned char frame = 1; frame < GuidelineRules::Lock::DELAY; frame++)
+	{
+		fast.step(0);
+		REQUIRE(fast.tetromino.getMinos() == landed);
+	}
+
+	fast.step(0);
+	REQUIRE(fast.matrix[landed[0].x][landed[0].y] != 0);
+}
+
+TEST_CASE("Auto shift follows DAS and ARR", "[gamesession]")
+{
+	auto getLeft = [](const GameSession& session)
+	{
+		int left = COLUMNS;
+
+		for (const Vector2i& mino : session.tetromino.getMinos())
+		{
+			left = std::min(left, mino.x);
+		}
+
+		return left;
+	};
+
+	// Milliseconds round down to 1/256 of a frame
+	REQUIRE(getHandlingTime(50) == 3 * HANDLING_ONE - 1);
+
+	// The defaults shift on the press and every four frames after
+	GameSession session(6);
+	session.currentGameState = GameState::IN_PROGRESS;
+	int spawnLeft = getLeft(session);
+
+	session.step(INPUT_LEFT);
+	REQUIRE(getLeft(session) == spawnLeft - 1);
+
+	for (unsigned char frame = 1; frame < 4; frame++)
+	{
+		session.step(INPUT_LEFT);
+		REQUIRE(getLeft(session) == spawnLeft - 1);
+	}
+
+	session.step(INPUT_LEFT);
+	REQUIRE(getLeft(session) == spawnLeft - 2);
+
+	// Releasing and pressing again shifts at once
+	session.step(0);
+	session.step(INPUT_LEFT);
+	REQUIRE(getLeft(session) == spawnLeft - 3);
+
+	// ARR 0 goes to the wall in the frame DAS runs out
+	GameSession instant(6);
+	instant.currentGameState = GameState::IN_PROGRESS;
+	instant.handling.das = 2 * HANDLING_ONE;
+	instant.handling.arr = 0;
+
+	instant.step(INPUT_LEFT);
+	instant.step(INPUT_LEFT);
+	REQUIRE(getLeft(instant) == spawnLeft - 1);
+	instant.step(INPUT_LEFT);
+	REQUIRE(getLeft(instant) == 0);
+	REQUIRE(instant.tetromino.getShiftDistance(-1, instant.matrix) == 0);
+
+	// A quarter frame ARR repeats four times a frame once it gets going
+	GameSession fast(6);
+	fast.currentGameState = GameState::IN_PROGRESS;
+	fast.handling.das = HANDLING_ONE;
+	fast.handling.arr = HANDLING_ONE / 4;
+	int wall = COLUMNS - 1 - fast.tetromino.getShiftDistance(1, fast.matrix);
+
+	fast.step(INPUT_RIGHT);
+	fast.step(INPUT_RIGHT);
+	REQUIRE(getLeft(fast) == spawnLeft + 2);
+	fast.step(INPUT_RIGHT);
+	REQUIRE(getLeft(fast) == std::min(spawnLeft + 6, spawnLeft + COLUMNS - 1 - wall));
+}
+
+TEST_CASE("Hard drop lands after a shift in the same frame", "[gamesession]")
+{
+	GameSession session(1);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	// A pillar just right of the piece, so a shift after the drop would leave it hanging off the pillar's side
+	int right = 0;
+
+	for (const Vector2i& mino : session.tetromino.getMinos())
+	{
+		right = std::max(right, mino.x);
+	}
+
+	for (unsigned char y = ROWS - 14; y < ROWS; y++)
+	{
+		session.matrix[right + 1][y] = 1;
+	}
+
+	Tetromino expected = session.tetromino;
+	expected.shift(1, 1, session.matrix);
+	expected.hardDrop(session.matrix);
+
+	session.step(INPUT_HARD_DROP | INPUT_RIGHT);
+
+	for (const Vector2i& mino : expected.getMinos())
+	{
+		REQUIRE(session.matrix[mino.x][mino.y] == 1 + expected.getShape());
+	}
+}
+
+TEST_CASE("Hard drop during a line clear does nothing", "[gamesession]")
+{
+	GameSession session(5);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	// The bottom row full but for the cells the piece drops into
+	std::array<Vector2i, 4> ghost = session.tetromino.getGhostMinos(session.matrix);
+
+	for (unsigned char x = 0; x < COLUMNS; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+	}
+
+	for (const Vector2i& mino : ghost)
+	{
+		session.matrix[mino.x][mino.y] = 0;
+	}
+
+	session.step(INPUT_HARD_DROP);
+	REQUIRE(session.clearLineTimer > 0);
+	int score = session.score;
+
+	session.step(0);
+	session.step(INPUT_HARD_DROP | INPUT_HOLD | INPUT_LEFT);
+	REQUIRE(session.score == score);
+
+	while (session.clearLineTimer > 0)
+	{
+		session.step(0);
+	}
+
+	// The next piece spawns and stays in play instead of locking where it appeared
+	std::array<Vector2i, 4> spawned = session.tetromino.getMinos();
+	session.step(0);
+	session.step(0);
+
+	REQUIRE(session.currentGameState == GameState::IN_PROGRESS);
+	REQUIRE_FALSE(session.tetromino.isHolding());
+
+	for (const Vector2i& mino : spawned)
+	{
+		REQUIRE(session.matrix[mino.x][mino.y] == 0);
+	}
+}
+
+TEST_CASE("Restart starts a new game from level 1", "[gamesession]")
+{
+	GameSession session(3);
+	session.currentGameState = GameState::GAME_OVER;
+	session.level = GUIDELINE_GRAVITY_LEVELS;
+	session.score = 1234;
+	session.totalLinesCleared = 140;
+	session.combo = 5;
+	session.backToBack = true;
+	session.matrix[0][ROWS - 1] = 1;
+
+	session.step(INPUT_START);
+
+	REQUIRE(session.currentGameState == GameState::IN_PROGRESS);
+	REQUIRE(session.level == 1);
+	REQUIRE(session.score == 0);
+	REQUIRE(session.totalLinesCleared == 0);
+	REQUIRE(session.combo == 0);
+	REQUIRE_FALSE(session.backToBack);
+	REQUIRE(session.matrix[0][ROWS - 1] == 0);
+
+	// Level 1 gravity, a row a second rather than the 20G the last game ended on
+	int spawnY = session.tetromino.getMinos()[0].y;
+
+	for (unsigned char frame = 1; frame < 60; frame++)
+	{
+		session.step(0);
+	}
+
+	REQUIRE(session.tetromino.getMinos()[0].y == spawnY);
+	session.step(0);
+	REQUIRE(session.tetromino.getMinos()[0].y == spawnY + 1);
+}
@@ -0,0 +1,32 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/InputQueue.hpp"
+
+TEST_CASE("Input events land in the frame they happened in", "[inputqueue]")
+{
+	InputQueue queue;
+	InputQueue::Clock::time_point start;
+	std::chrono::microseconds frame(FRAME_DURATION);
+
+	// Polled late, all in one batch
+	queue.push(INPUT_LEFT, true, start + frame / 2);
+	queue.push(INPUT_ROTATE_CW, true, start + frame + frame / 4);
+	queue.push(INPUT_ROTATE_CW, false, start + frame + frame / 2);
+	queue.push(INPUT_LEFT, false, start + frame * 2 + frame / 2);
+
+	REQUIRE(queue.popFrame(start + frame) == INPUT_LEFT);
+	// A tap inside one frame still registers once
+	REQUIRE(queue.popFrame(start + frame * 2) == (INPUT_LEFT | INPUT_ROTATE_CW));
+	REQUIRE(queue.popFrame(start + frame * 3) == 0);
+	REQUIRE(queue.popFrame(start + frame * 4) == 0);
+
+	// Overflowing folds the oldest events in rather than dropping them
+	for (unsigned char i = 0; i < INPUT_QUEUE_SIZE + 1; i++)
+	{
+		queue.push(i == 0 ? INPUT_HOLD : INPUT_DOWN, i % 2 == 0, start + frame * 5);
+	}
+
+	REQUIRE(queue.popFrame(start + frame * 6) == (INPUT_HOLD | INPUT_DOWN));
+	queue.clear();
+	REQUIRE(queue.popFrame(start + frame * 7) == 0);
+}
@@ -0,0 +1,52 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/LatencyProbe.hpp"
+
+TEST_CASE("Latency probe follows presses to display", "[latency]")
+{
+	LatencyProbe probe;
+	LatencyProbe::Clock::time_point start;
+	std::chrono::microseconds frame(FRAME_DURATION);
+	std::chrono::microseconds ms(1000);
+
+	// A left press 4 ms before the frame ends, and a rotate that misses it
+	probe.received(INPUT_LEFT, start + frame - ms * 4);
+	probe.received(INPUT_ROTATE_CW, start + frame + ms);
+	probe.consumed(start + frame, start + frame + ms * 2);
+	probe.drawn(start + frame, start + frame + ms * 3);
+	probe.presented(start + frame + ms * 5);
+
+	REQUIRE(probe.getSampleCount(0) == 1);
+	REQUIRE(probe.getSampleCount(4) == 0);
+	REQUIRE(probe.getPercentile(0, LATENCY_CONSUMED, 50) == 6000);
+	REQUIRE(probe.getPercentile(0, LATENCY_DRAWN, 50) == 7000);
+	REQUIRE(probe.getPercentile(0, LATENCY_PRESENTED, 50) == 9000);
+
+	probe.consumed(start + frame * 2, start + frame * 2);
+	// Drawing an older frame doesn't show it
+	probe.drawn(start + frame, start + frame * 2);
+	probe.presented(start + frame * 2);
+	REQUIRE(probe.getSampleCount(4) == 0);
+	probe.drawn(start + frame * 2, start + frame * 2);
+	probe.presented(start + frame * 2 + ms);
+	REQUIRE(probe.getSampleCount(4) == 1);
+	REQUIRE(probe.getPercentile(4, LATENCY_PRESENTED, 99) == FRAME_DURATION);
+
+	std::ostringstream report;
+	probe.report(report);
+	REQUIRE(report.str().find("rotate cw") != std::string::npos);
+	REQUIRE(report.str().find("hold") == std::string::npos);
+
+	// Synthetic input presses and releases every kind in turn
+	SyntheticInput synthetic(start, ms * 100);
+	unsigned char bits;
+	bool pressed;
+
+	REQUIRE(synthetic.poll(start, bits, pressed));
+	REQUIRE((bits == INPUT_LEFT && pressed));
+	REQUIRE_FALSE(synthetic.poll(start + ms * 49, bits, pressed));
+	REQUIRE(synthetic.poll(start + ms * 50, bits, pressed));
+	REQUIRE((bits == INPUT_LEFT && !pressed));
+	REQUIRE(synthetic.poll(start + ms * 100, bits, pressed));
+	REQUIRE((bits == INPUT_RIGHT && pressed));
+}
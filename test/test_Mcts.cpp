@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/GameSession.hpp"
+#include "Headers/Mcts.hpp"
+
+TEST_CASE("SearchState tracks the bag like the randomizer", "[mcts]")
+{
+	GameSession session(3);
+	SearchState state = SearchState::fromSession(session);
+
+	Tetromino tetromino = session.tetromino;
+	Matrix empty {};
+
+	// Every shape the real bag hands out next has to be one the search considers possible
+	for (unsigned char i = 0; i < 20; i++)
+	{
+		tetromino.reset(empty);
+		Tetromino::Shape shape = tetromino.getNextShape();
+
+		REQUIRE((state.getDrawMask() & (1 << shape)) != 0);
+		state.draw(shape);
+		REQUIRE(state.bag == tetromino.getBagMask());
+	}
+}
+
+TEST_CASE("Mcts clears a line when it can", "[mcts]")
+{
+	GameSession session(7);
+
+	for (unsigned char x = 0; x < COLUMNS - 1; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+		session.matrix[x][ROWS - 2] = 1;
+	}
+
+	SearchState state = SearchState::fromSession(session);
+	state.queue[0] = Tetromino::Shape::I;
+
+	Mcts mcts(2, 1 << 12);
+	REQUIRE_FALSE(mcts.setState(state));
+	REQUIRE(mcts.think(std::chrono::milliseconds(20)) > 0);
+
+	Tetromino best(1);
+	bool useHold = true;
+	REQUIRE(mcts.getBestMove(best, useHold));
+	REQUIRE_FALSE(useHold);
+
+	for (const Vector2i& mino : best.getMinos())
+	{
+		REQUIRE(mino.x == COLUMNS - 1);
+	}
+}
+
+TEST_CASE("Mcts plays legal moves and keeps its tree between moves", "[mcts]")
+{
+	GameSession session(11);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	Mcts mcts(4, 1 << 14);
+	MoveGenerator generator;
+	unsigned int reused = 0;
+
+	for (unsigned char piece = 0; piece < 30; piece++)
+	{
+		reused += mcts.setState(SearchState::fromSession(session));
+
+		auto start = std::chrono::steady_clock::now();
+		mcts.think(std::chrono::milliseconds(5));
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+
+		Tetromino best(1);
+		bool useHold;
+		REQUIRE(mcts.getBestMove(best, useHold));
+
+		if (useHold)
+		{
+			REQUIRE(session.hold());
+		}
+
+		// Place the session's own piece so its hold and bag carry over
+		REQUIRE(best.getShape() == session.tetromino.getShape());
+		generator.generate(session.matrix, session.tetromino);
+		int index = generator.find(best.getMinos());
+		REQUIRE(index >= 0);
+		REQUIRE(session.place(generator.getPlacement(index)));
+		REQUIRE(session.currentGameState != GameState::GAME_OVER);
+	}
+
+	REQUIRE(reused > 0);
+	REQUIRE(mcts.getFreeNodeCount() > 0);
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+
+TEST_CASE("MoveGenerator finds every placement on an empty board", "[movegenerator]")
+{
+	Matrix matrix {};
+	Tetromino tetromino(1);
+	MoveGenerator generator;
+
+	// Distinct resting cell sets per shape on an empty 10 wide board
+	const std::array<unsigned short, 7> expected = { 17, 34, 34, 9, 17, 34, 17 };
+
+	for (unsigned char shape = 0; shape < 7; shape++)
+	{
+		tetromino.reset(static_cast<Tetromino::Shape>(shape), matrix);
+
+		REQUIRE(generator.generate(matrix, tetromino) == expected[shape]);
+
+		for (unsigned short i = 0; i < generator.getPlacementCount(); i++)
+		{
+			Tetromino placement = generator.getPlacement(i);
+			REQUIRE_FALSE(placement.moveDown(matrix));
+		}
+	}
+}
+
+TEST_CASE("MoveGenerator respects overhangs", "[movegenerator]")
+{
+	Matrix matrix {};
+	Tetromino tetromino(1);
+	MoveGenerator generator;
+
+	// Roof over the whole left side with an open column on the right
+	for (unsigned char x = 0; x < COLUMNS - 1; x++)
+	{
+		matrix[x][ROWS - 3] = 1;
+	}
+
+	tetromino.reset(Tetromino::Shape::O, matrix);
+	generator.generate(matrix, tetromino);
+
+	std::array<Vector2i, 4> underRoof = { Vector2i(0, ROWS - 1), Vector2i(1, ROWS - 1), Vector2i(0, ROWS - 2), Vector2i(1, ROWS - 2) };
+	std::array<Vector2i, 4> onRoof = { Vector2i(0, ROWS - 4), Vector2i(1, ROWS - 4), Vector2i(0, ROWS - 5), Vector2i(1, ROWS - 5) };
+
+	REQUIRE(generator.find(underRoof) == -1);
+	REQUIRE(generator.find(onRoof) >= 0);
+
+	// An I piece can soft drop down the open column
+	tetromino.reset(Tetromino::Shape::I, matrix);
+	generator.generate(matrix, tetromino);
+
+	std::array<Vector2i, 4> inWell = { Vector2i(COLUMNS - 1, ROWS - 1), Vector2i(COLUMNS - 1, ROWS - 2), Vector2i(COLUMNS - 1, ROWS - 3), Vector2i(COLUMNS - 1, ROWS - 4) };
+	REQUIRE(generator.find(inWell) >= 0);
+}
+
+TEST_CASE("MoveGenerator tells apart placements far apart on the board", "[movegenerator]")
+{
+	Matrix matrix {};
+	Tetromino tetromino(1);
+	MoveGenerator generator;
+
+	// A stack on the left tall enough that its top lies more than 256 search cells above the floor beside it
+	for (unsigned char x = 0; x < 4; x++)
+	{
+		for (unsigned char y = ROWS - 14; y < ROWS; y++)
+		{
+			matrix[x][y] = 1;
+		}
+	}
+
+	tetromino.reset(Tetromino::Shape::O, matrix);
+
+	// Three on the stack, one hanging off its edge and five on the floor
+	REQUIRE(generator.generate(matrix, tetromino) == 9);
+
+	std::array<Vector2i, 4> onStack = { Vector2i(0, ROWS - 15), Vector2i(1, ROWS - 15), Vector2i(0, ROWS - 16), Vector2i(1, ROWS - 16) };
+	std::array<Vector2i, 4> onFloor = { Vector2i(4, ROWS - 1), Vector2i(5, ROWS - 1), Vector2i(4, ROWS - 2), Vector2i(5, ROWS - 2) };
+
+	REQUIRE(MoveGenerator::getCellKey(onStack) != MoveGenerator::getCellKey(onFloor));
+
+	int index = generator.find(onFloor);
+	REQUIRE(index >= 0);
+	REQUIRE(MoveGenerator::getCellKey(generator.getPlacement(index).getMinos()) == MoveGenerator::getCellKey(onFloor));
+	REQUIRE(generator.find(onStack) != index);
+}
+
+TEST_CASE("GameSession places and clears lines", "[movegenerator]")
+{
+	GameSession session(7);
+	session.currentGameState = GameState::IN_PROGRESS;
+
+	for (unsigned char x = 0; x < COLUMNS - 1; x++)
+	{
+		session.matrix[x][ROWS - 1] = 1;
+	}
+
+	session.tetromino.reset(Tetromino::Shape::I, session.matrix);
+
+	MoveGenerator generator;
+	generator.generate(session.matrix, session.tetromino);
+
+	std::array<Vector2i, 4> inWell = { Vector2i(COLUMNS - 1, ROWS - 1), Vector2i(COLUMNS - 1, ROWS - 2), Vector2i(COLUMNS - 1, ROWS - 3), Vector2i(COLUMNS - 1, ROWS - 4) };
+	int index = generator.find(inWell);
+	REQUIRE(index >= 0);
+
+	REQUIRE(session.place(generator.getPlacement(index)));
+	REQUIRE(session.totalLinesCleared == 1);
+	REQUIRE(session.score == 100);
+	REQUIRE(session.matrix[COLUMNS - 1][ROWS - 1] != 0);
+	REQUIRE(session.matrix[0][ROWS - 1] == 0);
+}
+
+TEST_CASE("MoveGenerator throughput", "[movegenerator][!benchmark]")
+{
+	Matrix matrix {};
+	Tetromino tetromino(1);
+	tetromino.reset(Tetromino::Shape::T, matrix);
+	MoveGenerator generator;
+
+	BENCHMARK("generate T on an empty board")
+	{
+		return generator.generate(matrix, tetromino);
+	};
+}
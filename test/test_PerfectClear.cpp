@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/GameSession.hpp"
+#include "Headers/MoveGenerator.hpp"
+#include "Headers/PerfectClear.hpp"
+
+namespace
+{
+// The session's current piece followed by the next count - 1 pieces it will draw
+SearchState getOpeningState(const GameSession& session, unsigned char count)
+{
+	SearchState state = SearchState::fromSession(session);
+	Tetromino preview = session.tetromino;
+	Matrix empty {};
+
+	for (state.queueLength = 2; state.queueLength < count; state.queueLength++)
+	{
+		preview.reset(empty);
+		state.queue[state.queueLength] = preview.getNextShape();
+	}
+
+	return state;
+}
+
+// Plays a solution through the engine, failing if any placement isn't one the engine can reach
+bool playSolution(GameSession& session, const std::vector<PerfectClearMove>& solution)
+{
+	MoveGenerator generator;
+
+	for (const PerfectClearMove& move : solution)
+	{
+		if (move.useHold && !session.hold())
+		{
+			return false;
+		}
+
+		if (session.tetromino.getShape() != move.shape)
+		{
+			return false;
+		}
+
+		generator.generate(session.matrix, session.tetromino);
+		int index = generator.find(move.minos);
+
+		if (index < 0 || !session.place(generator.getPlacement(index)))
+		{
+			return false;
+		}
+
+		session.hasHeld = false;
+	}
+
+	return true;
+}
+}
+
+TEST_CASE("PerfectClear solves the 4 line opener", "[perfectclear]")
+{
+	PerfectClear solver;
+	std::vector<PerfectClearMove> solution;
+
+	for (unsigned long long seed = 1; seed <= 8; seed++)
+	{
+		GameSession session(seed);
+		session.currentGameState = GameState::IN_PROGRESS;
+
+		REQUIRE(solver.solve(getOpeningState(session, 11), 10, 4, solution));
+		REQUIRE(solution.size() == 10);
+		REQUIRE(playSolution(session, solution));
+		REQUIRE(session.matrix == Matrix {});
+	}
+}
+
+TEST_CASE("PerfectClear rejects impossible boards", "[perfectclear]")
+{
+	PerfectClear solver(1);
+	std::vector<PerfectClearMove> solution;
+	GameSession session(3);
+	SearchState state = getOpeningState(session, 11);
+
+	// 39 empty cells can't be filled by whole pieces
+	state.matrix[0][ROWS - 1] = 1;
+	REQUIRE_FALSE(solver.solve(state, 10, 4, solution));
+
+	// Something above the rows to clear
+	state.matrix[0][ROWS - 1] = 0;
+	state.matrix[0][ROWS - 5] = 1;
+	REQUIRE_FALSE(solver.solve(state, 10, 4, solution));
+
+	// Not enough pieces
+	state.matrix[0][ROWS - 5] = 0;
+	REQUIRE_FALSE(solver.solve(state, 9, 4, solution));
+}
+
+TEST_CASE("PerfectClear opener time", "[perfectclear][!benchmark]")
+{
+	PerfectClear solver;
+	std::vector<PerfectClearMove> solution;
+	GameSession session(1);
+	SearchState state = getOpeningState(session, 11);
+
+	BENCHMARK("Solve the 4 line opener")
+	{
+		return solver.solve(state, 10, 4, solution);
+	};
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/Replay.hpp"
+
+TEST_CASE("Replay round trip and divergence report", "[replay]")
+{
+	Handling handling;
+	handling.das = getHandlingTime(100);
+	handling.arr = 0;
+
+	Replay replay(2024);
+	replay.setHandling(handling);
+	GameSession session(2024);
+	session.handling = handling;
+	std::minstd_rand random(5);
+
+	for (int frame = 0; frame < 600; frame++)
+	{
+		unsigned char input = random() & (INPUT_LEFT | INPUT_RIGHT | INPUT_ROTATE_CW | INPUT_HARD_DROP | INPUT_START);
+		session.step(input);
+		replay.record(input, session.hash());
+	}
+
+	std::string path = (util::fs::temp_directory_path() / "tetris_test.replay").string();
+	REQUIRE(replay.save(path));
+
+	Replay loaded;
+	REQUIRE(loaded.load(path));
+	REQUIRE(loaded.getSeed() == 2024);
+	REQUIRE(loaded.getFrameCount() == 600);
+	REQUIRE(loaded.getHandling().das == handling.das);
+	REQUIRE(loaded.getHandling().arr == 0);
+
+	std::ostringstream report;
+	REQUIRE(loaded.verify(report) == -1);
+
+	// A replay recorded with a different seed diverges on the first frame
+	Replay other(2025);
+	other.record(loaded.getInput(0), loaded.getHash(0));
+	REQUIRE(other.verify(report) == 0);
+	REQUIRE(report.str().find("diverged at frame 0") != std::string::npos);
+
+	// A truncated file is rejected instead of loading zeroed frames, as is a frame count past the end of the file
+	util::fs::resize_file(path, util::fs::file_size(path) - 5);
+	REQUIRE_FALSE(loaded.load(path));
+
+	{
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		// The frame count follows the magic, version, seed and handling
+		file.seekp(4 + 1 + 8 + 2 + 2 + 1);
+		file.write("\xFF\xFF\xFF\xFF", 4);
+	}
+
+	REQUIRE_FALSE(loaded.load(path));
+
+	util::fs::remove(path);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/Rollback.hpp"
+
+TEST_CASE("Rollback sessions converge on the same game as local play", "[rollback]")
+{
+	const int delay = GENERATE(1, 4, 7);
+	const int frames = 1200;
+	const int idleFrames = 30;
+
+	RollbackSession peers[2] = { RollbackSession(0, 1234), RollbackSession(1, 1234) };
+	GameSession reference[2] = { GameSession(1234), GameSession(1235) };
+
+	std::minstd_rand random(42);
+	unsigned char inputs[2] = { INPUT_START, INPUT_START };
+
+	// Inputs in flight, delivered delay frames after they were sent
+	std::deque<std::pair<int, unsigned char>> wire[2];
+
+	for (int frame = 0; frame < frames + idleFrames; frame++)
+	{
+		for (unsigned char player = 0; player < 2; player++)
+		{
+			if (frame >= frames)
+			{
+				inputs[player] = 0;
+			}
+			else if (random() % 6 == 0)
+			{
+				// Hold a button combination for a few frames, like a player would
+				inputs[player] = random() & (INPUT_LEFT | INPUT_RIGHT | INPUT_DOWN | INPUT_ROTATE_CW | INPUT_HARD_DROP | INPUT_HOLD | INPUT_START);
+			}
+
+			while (!wire[player].empty() && wire[player].front().first + delay <= frame)
+			{
+				peers[1 - player].addRemoteInput(wire[player].front().first, wire[player].front().second);
+				wire[player].pop_front();
+			}
+
+			REQUIRE(peers[player].canAdvance());
+			peers[player].advanceFrame(inputs[player]);
+			wire[player].emplace_back(frame, inputs[player]);
+			reference[player].step(inputs[player]);
+		}
+	}
+
+	REQUIRE(reference[0].score > 0);
+	REQUIRE(reference[1].score > 0);
+
+	for (unsigned char player = 0; player < 2; player++)
+	{
+		REQUIRE(peers[0].getPlayer(player).hash() == reference[player].hash());
+		REQUIRE(peers[1].getPlayer(player).hash() == reference[player].hash());
+	}
+}
+
+TEST_CASE("Rollback stalls once the prediction window is used up", "[rollback]")
+{
+	RollbackSession session(0, 1);
+
+	for (int frame = 0; frame < MAX_ROLLBACK_FRAMES; frame++)
+	{
+		REQUIRE(session.canAdvance());
+		session.advanceFrame(0);
+	}
+
+	REQUIRE_FALSE(session.canAdvance());
+
+	session.addRemoteInput(0, INPUT_START);
+
+	REQUIRE(session.canAdvance());
+	session.advanceFrame(0);
+	REQUIRE(session.getLastRollbackFrames() == MAX_ROLLBACK_FRAMES);
+}
+
+TEST_CASE("Rollback reports the first frame where remote hashes differ", "[rollback]")
+{
+	RollbackSession peers[2] = { RollbackSession(0, 7), RollbackSession(1, 7) };
+
+	for (int frame = 0; frame < 20; frame++)
+	{
+		peers[0].advanceFrame(INPUT_START);
+		peers[1].advanceFrame(INPUT_START);
+		peers[0].addRemoteInput(frame, INPUT_START);
+		peers[1].addRemoteInput(frame, INPUT_START);
+	}
+
+	peers[0].addRemoteHash(10, peers[1].getFrameHash(10));
+	REQUIRE(peers[0].checkDesync() == -1);
+
+	peers[0].addRemoteHash(12, peers[1].getFrameHash(12) ^ 1);
+	peers[0].addRemoteHash(15, peers[1].getFrameHash(15) ^ 1);
+	REQUIRE(peers[0].checkDesync() == 12);
+
+	// Frames the local side hasn't confirmed yet are held back
+	peers[0].advanceFrame(INPUT_START);
+	peers[0].addRemoteHash(20, 0);
+	REQUIRE(peers[0].checkDesync() == -1);
+}
+
+TEST_CASE("Rollback resimulation", "[rollback][!benchmark]")
+{
+	RollbackSession session(0, 1);
+
+	for (int frame = 0; frame < MAX_ROLLBACK_FRAMES; frame++)
+	{
+		session.advanceFrame(INPUT_START);
+	}
+
+	int remoteFrame = 0;
+
+	BENCHMARK("full rollback window")
+	{
+		// Every confirmed input contradicts the prediction, forcing the longest possible rollback
+		session.addRemoteInput(remoteFrame, remoteFrame % 2 ? INPUT_LEFT : INPUT_RIGHT);
+		remoteFrame++;
+		session.advanceFrame(INPUT_DOWN);
+		return session.getLastRollbackFrames();
+	};
+}
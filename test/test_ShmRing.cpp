@@ -0,0 +1,174 @@
+#ifdef __linux__
+	#include <catch2/catch.hpp>
+
+	#include "Headers/ShmRing.hpp"
+	#include "Headers/VecEnv.hpp"
+
+	#include <chrono>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+
+namespace
+{
+/// @brief Forks a producer that streams count transitions through a ring opened by name, then closes it
+pid_t startProducer(const std::string& name, unsigned int count)
+{
+	pid_t child = fork();
+
+	if (child != 0)
+	{
+		return child;
+	}
+
+	ShmRing ring;
+
+	if (!ring.open(name))
+	{
+		_exit(1);
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		Transition* transition = static_cast<Transition*>(ring.beginWrite());
+
+		if (transition == nullptr)
+		{
+			_exit(2);
+		}
+
+		transition->env = i;
+		transition->reward = i * 0.5f;
+		std::memset(transition->observation, i & 0xFF, VECENV_OBSERVATION_SIZE);
+		ring.endWrite();
+	}
+
+	ring.close();
+	ring.detach();
+	_exit(0);
+}
+}
+
+TEST_CASE("ShmRing delivers every transition in order between processes", "[shmring]")
+{
+	const std::string name = "/tetris_test_ring_" + std::to_string(getpid());
+	const unsigned int count = 20000;
+
+	// A tiny ring forces both sides through the full and empty waits
+	ShmRing ring;
+	REQUIRE(ring.create(name, sizeof(Transition), 4));
+	REQUIRE(ring.getCapacity() == 4);
+
+	pid_t producer = startProducer(name, count);
+	Transition transition;
+	unsigned int received = 0;
+
+	while (ring.pop(&transition))
+	{
+		REQUIRE(transition.env == received);
+		REQUIRE(transition.reward == received * 0.5f);
+		REQUIRE(transition.observation[VECENV_OBSERVATION_SIZE - 1] == (received & 0xFF));
+		received++;
+
+		// Let the producer fill the ring and sleep now and then
+		if (received % 5000 == 0)
+		{
+			usleep(2000);
+		}
+	}
+
+	int status = -1;
+	waitpid(producer, &status, 0);
+
+	REQUIRE(received == count);
+	REQUIRE(WIFEXITED(status));
+	REQUIRE(WEXITSTATUS(status) == 0);
+}
+
+TEST_CASE("ShmRing rejects bad sizes", "[shmring]")
+{
+	const std::string name = "/tetris_test_bad_ring_" + std::to_string(getpid());
+
+	ShmRing ring;
+	REQUIRE_FALSE(ring.create(name, sizeof(Transition), 0));
+	REQUIRE_FALSE(ring.create(name, sizeof(Transition), 0x80000001));
+	REQUIRE(ring.create(name, sizeof(Transition), 8));
+
+	// A segment cut short of the slots its header claims can't be attached
+	int descriptor = shm_open(name.c_str(), O_RDWR, 0600);
+	REQUIRE(descriptor >= 0);
+	REQUIRE(ftruncate(descriptor, 256) == 0);
+	close(descriptor);
+
+	ShmRing reader;
+	REQUIRE_FALSE(reader.open(name));
+}
+
+TEST_CASE("VecEnv steps straight into ring slots", "[shmring]")
+{
+	const std::string name = "/tetris_test_env_ring_" + std::to_string(getpid());
+	const unsigned int count = 4;
+
+	// Each side keeps its own position, so the reader is a second attachment
+	ShmRing ring;
+	ShmRing reader;
+	REQUIRE(ring.create(name, sizeof(Transition), 8));
+	REQUIRE(reader.open(name));
+
+	VecEnv env(count, 9);
+	VecEnv reference(count, 9);
+	std::vector<unsigned char> observations(count * VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> actions(count, 3);
+	std::vector<float> rewards(count);
+	std::vector<unsigned char> dones(count);
+
+	reference.step(actions.data(), observations.data(), rewards.data(), dones.data());
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		env.step(i, actions[i], *static_cast<Transition*>(ring.beginWrite()));
+		ring.endWrite();
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const Transition* transition = static_cast<const Transition*>(reader.beginRead());
+
+		REQUIRE(transition->env == i);
+		REQUIRE(transition->done == dones[i]);
+		REQUIRE(std::memcmp(transition->observation, observations.data() + i * VECENV_OBSERVATION_SIZE, VECENV_OBSERVATION_SIZE) == 0);
+		reader.endRead();
+	}
+}
+
+TEST_CASE("ShmRing loopback throughput", "[shmring][!benchmark]")
+{
+	const std::string name = "/tetris_bench_ring_" + std::to_string(getpid());
+	const unsigned int count = 5000000;
+
+	ShmRing ring;
+	REQUIRE(ring.create(name, sizeof(Transition), 4096));
+
+	auto start = std::chrono::steady_clock::now();
+	pid_t producer = startProducer(name, count);
+	unsigned int received = 0;
+	unsigned long long checksum = 0;
+
+	for (const void* slot = ring.beginRead(); slot != nullptr; slot = ring.beginRead())
+	{
+		checksum += static_cast<const Transition*>(slot)->env;
+		ring.endRead();
+		received++;
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	waitpid(producer, nullptr, 0);
+
+	REQUIRE(received == count);
+	REQUIRE(checksum == static_cast<unsigned long long>(count) * (count - 1) / 2);
+
+	std::cout << "ShmRing loopback: " << std::fixed << std::setprecision(2) << count / seconds / 1e6 << " M transitions/s ("
+			  << sizeof(Transition) << " byte slots)" << std::endl;
+}
+#endif // __linux__
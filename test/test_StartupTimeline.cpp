@@ -0,0 +1,31 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/StartupTimeline.hpp"
+
+TEST_CASE("Startup timeline reports stages in the order they finished", "[startup]")
+{
+	StartupTimeline::Clock::time_point launch = StartupTimeline::Clock::now();
+	StartupTimeline timeline(launch);
+
+	timeline.mark("window", launch + std::chrono::milliseconds(30));
+	timeline.mark("font", launch + std::chrono::milliseconds(10));
+	timeline.mark("first-present", launch + std::chrono::milliseconds(45));
+
+	REQUIRE(timeline.getStageCount() == 3);
+	REQUIRE(timeline.getElapsed("font") == Approx(10));
+	REQUIRE(timeline.getElapsed("first-present") == Approx(45));
+	REQUIRE(timeline.getElapsed("audio") < 0);
+
+	std::ostringstream out;
+	timeline.report(out);
+	REQUIRE(out.str() == "startup font 10.00 10.00\nstartup window 30.00 20.00\nstartup first-present 45.00 15.00\n");
+
+	// Marks past the capacity are dropped rather than overwriting earlier stages
+	for (unsigned char i = 0; i < STARTUP_STAGES; i++)
+	{
+		timeline.mark("extra");
+	}
+
+	REQUIRE(timeline.getStageCount() == STARTUP_STAGES);
+	REQUIRE(timeline.getElapsed("window") == Approx(30));
+}
@@ -0,0 +1,67 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/TetrisCore.h"
+
+TEST_CASE("C API sessions match snapshots and placements", "[tetriscore]")
+{
+	REQUIRE(tetris_abi_version() == TETRIS_CORE_ABI_VERSION);
+
+	TetrisSession* session = tetris_session_create(42);
+	std::vector<unsigned char> snapshot(tetris_snapshot_size());
+	std::vector<TetrisPlacement> placements(TETRIS_MAX_PLACEMENTS);
+
+	tetris_session_snapshot(session, snapshot.data());
+	unsigned long long startHash = tetris_session_hash(session);
+
+	REQUIRE(tetris_session_place(session, 0) == -1);
+
+	for (int piece = 0; piece < 10; piece++)
+	{
+		unsigned int count = tetris_session_placements(session, placements.data(), placements.size());
+		REQUIRE(count > 0);
+		REQUIRE(tetris_session_place(session, count / 2) == 1);
+		REQUIRE(tetris_session_place(session, 0) == -1);
+	}
+
+	std::vector<unsigned char> board(TETRIS_BOARD_ROWS * TETRIS_BOARD_COLUMNS);
+	tetris_session_board(session, board.data());
+	REQUIRE(std::count(board.begin(), board.end(), 0) < static_cast<long>(board.size()));
+
+	tetris_session_restore(session, snapshot.data());
+	REQUIRE(tetris_session_hash(session) == startHash);
+
+	tetris_session_destroy(session);
+}
+
+TEST_CASE("C API call overhead", "[tetriscore][!benchmark]")
+{
+	TetrisSession* session = tetris_session_create(1);
+	std::vector<unsigned char> snapshot(tetris_snapshot_size());
+	std::vector<TetrisPlacement> placements(TETRIS_MAX_PLACEMENTS);
+	unsigned char input = 0;
+
+	BENCHMARK("snapshot")
+	{
+		tetris_session_snapshot(session, snapshot.data());
+		return snapshot[0];
+	};
+
+	BENCHMARK("restore")
+	{
+		tetris_session_restore(session, snapshot.data());
+		return tetris_session_score(session);
+	};
+
+	BENCHMARK("step one frame")
+	{
+		tetris_session_step(session, &input, 1);
+		return tetris_session_state(session);
+	};
+
+	BENCHMARK("placements")
+	{
+		return tetris_session_placements(session, placements.data(), placements.size());
+	};
+
+	tetris_session_destroy(session);
+}
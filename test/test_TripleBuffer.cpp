@@ -0,0 +1,50 @@
+#include <catch2/catch.hpp>
+
+#include "Headers/TripleBuffer.hpp"
+
+TEST_CASE("Triple buffer hands over the latest value", "[triplebuffer]")
+{
+	TripleBuffer<int> buffer;
+	REQUIRE_FALSE(buffer.update());
+
+	buffer.getBack() = 1;
+	buffer.publish();
+	buffer.getBack() = 2;
+	buffer.publish();
+
+	// Values published faster than they are read are skipped
+	REQUIRE(buffer.update());
+	REQUIRE(buffer.getFront() == 2);
+	REQUIRE_FALSE(buffer.update());
+	REQUIRE(buffer.getFront() == 2);
+
+	// The consumer never sees a value torn or out of order across threads
+	TripleBuffer<std::array<int, 64>> frames;
+	std::thread producer([&]()
+	{
+		for (int value = 1; value <= 100000; value++)
+		{
+			frames.getBack().fill(value);
+			frames.publish();
+		}
+	});
+
+	int last = 0;
+
+	while (last < 100000)
+	{
+		if (frames.update())
+		{
+			const std::array<int, 64>& frame = frames.getFront();
+			REQUIRE(std::all_of(frame.begin(), frame.end(), [&](int value) { return value == frame[0]; }));
+			REQUIRE(frame[0] > last);
+			last = frame[0];
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	producer.join();
+}
@@ -0,0 +1,209 @@
+#include <catch2/catch.hpp>
+
+#include <limits>
+
+#include "Headers/VecEnv.hpp"
+
+TEST_CASE("VecEnv is deterministic for a seed", "[vecenv]")
+{
+	const unsigned int count = 16;
+	VecEnv a(count, 5);
+	VecEnv b(count, 5);
+
+	std::vector<unsigned char> observationsA(count * VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> observationsB(count * VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> actions(count);
+	std::vector<float> rewards(count);
+	std::vector<unsigned char> dones(count);
+
+	a.reset(observationsA.data());
+	b.reset(observationsB.data());
+	REQUIRE(observationsA == observationsB);
+
+	for (int step = 0; step < 200; step++)
+	{
+		for (unsigned int env = 0; env < count; env++)
+		{
+			actions[env] = (step * 7 + env * 13) % VECENV_ACTIONS;
+		}
+
+		a.step(actions.data(), observationsA.data(), rewards.data(), dones.data());
+		b.step(actions.data(), observationsB.data(), rewards.data(), dones.data());
+		REQUIRE(observationsA == observationsB);
+	}
+}
+
+TEST_CASE("VecEnv observations and auto reset", "[vecenv]")
+{
+	const unsigned int count = 8;
+	VecEnv env(count, 11);
+
+	std::vector<unsigned char> observations(count * VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> actions(count, 0);
+	std::vector<float> rewards(count);
+	std::vector<unsigned char> dones(count);
+
+	env.reset(observations.data());
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const unsigned char* observation = observations.data() + i * VECENV_OBSERVATION_SIZE;
+
+		REQUIRE(std::count(observation, observation + ROWS * COLUMNS, 1) == 0);
+		REQUIRE(std::count(observation + VECENV_PIECE_OFFSET, observation + VECENV_HOLD_OFFSET, 1) == 1);
+		REQUIRE(observation[VECENV_HOLD_OFFSET + 7] == 1);
+		REQUIRE(std::count(observation + VECENV_PREVIEW_OFFSET, observation + VECENV_MASK_OFFSET, 1) == VECENV_PREVIEWS);
+		REQUIRE(std::count(observation + VECENV_MASK_OFFSET, observation + VECENV_OBSERVATION_SIZE, 1) > 0);
+	}
+
+	// Always dropping in the left column tops out quickly, every game must restart on an empty board
+	unsigned int finished = 0;
+
+	for (int step = 0; step < 100; step++)
+	{
+		env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (dones[i])
+			{
+				finished++;
+				REQUIRE(std::count(observations.data() + i * VECENV_OBSERVATION_SIZE, observations.data() + i * VECENV_OBSERVATION_SIZE + ROWS * COLUMNS, 1) == 0);
+			}
+		}
+	}
+
+	REQUIRE(finished >= count);
+}
+
+TEST_CASE("VecEnv clears lines", "[vecenv]")
+{
+	VecEnv env(1, 3);
+	std::vector<unsigned char> observation(VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> legal(VECENV_ACTIONS);
+	float reward = 0;
+	unsigned char done = 0;
+	float total = 0;
+
+	env.reset(observation.data());
+
+	// Greedy one piece lookahead on stack height and holes
+	for (int step = 0; step < 300 && !done; step++)
+	{
+		unsigned char best = 0;
+		int bestCost = std::numeric_limits<int>::max();
+
+		for (unsigned short action = 0; action < VECENV_ACTIONS; action++)
+		{
+			if (!observation[VECENV_MASK_OFFSET + action])
+			{
+				continue;
+			}
+
+			VecEnv trial = env;
+			std::vector<unsigned char> next(VECENV_OBSERVATION_SIZE);
+			float trialReward = 0;
+			unsigned char trialDone = 0;
+			unsigned char trialAction = action;
+			trial.step(&trialAction, next.data(), &trialReward, &trialDone);
+
+			int cost = trialDone ? std::numeric_limits<int>::max() - 1 : 0;
+
+			for (unsigned char x = 0; x < COLUMNS && !trialDone; x++)
+			{
+				bool covered = false;
+
+				for (unsigned char y = 0; y < ROWS; y++)
+				{
+					if (next[y * COLUMNS + x])
+					{
+						cost += covered ? 0 : ROWS - y;
+						covered = true;
+					}
+					else if (covered)
+					{
+						cost += 8;
+					}
+				}
+			}
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				best = action;
+			}
+		}
+
+		env.step(&best, observation.data(), &reward, &done);
+		total += reward;
+	}
+
+	// Rewards add up to the game's score, which resets along with the game
+	REQUIRE(total > 0);
+
+	if (!done)
+	{
+		REQUIRE(total == env.getScore(0));
+	}
+}
+
+namespace
+{
+// Reaches in to set up a board directly
+struct BoardEnv : VecEnv
+{
+	using VecEnv::VecEnv;
+	using VecEnv::canSpawn;
+	using VecEnv::m_Boards;
+};
+}
+
+TEST_CASE("VecEnv blocks out where pieces spawn", "[vecenv]")
+{
+	BoardEnv env(1, 4);
+
+	// Hidden rows above where pieces spawn don't block them
+	for (unsigned char y = 0; y + 1 < StandardBoard::SPAWN_Y; y++)
+	{
+		env.m_Boards[0][y] = StandardBoard::FULL_ROW;
+	}
+
+	REQUIRE(env.canSpawn(0));
+
+	// A row across the spawn with a gap out of the way, it stays after the next piece lands on it
+	env.m_Boards[0] = {};
+	env.m_Boards[0][StandardBoard::SPAWN_Y] = StandardBoard::FULL_ROW & ~1;
+	REQUIRE_FALSE(env.canSpawn(0));
+
+	std::vector<unsigned char> observation(VECENV_OBSERVATION_SIZE);
+	float reward = 0;
+	unsigned char done = 0;
+	unsigned char action = COLUMNS - 3;
+	env.step(&action, observation.data(), &reward, &done);
+
+	REQUIRE(done);
+}
+
+TEST_CASE("VecEnv throughput", "[vecenv][!benchmark]")
+{
+	const unsigned int count = 1024;
+	VecEnv env(count, 1, 200);
+
+	std::vector<unsigned char> observations(count * VECENV_OBSERVATION_SIZE);
+	std::vector<unsigned char> actions(count);
+	std::vector<float> rewards(count);
+	std::vector<unsigned char> dones(count);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		actions[i] = i % VECENV_ACTIONS;
+	}
+
+	env.reset(observations.data());
+
+	BENCHMARK("step 1024 games")
+	{
+		env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+		return rewards[0];
+	};
+}